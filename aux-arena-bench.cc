@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <aux/arena.hpp>
+#include <aux/versor.hpp>
+
+#include <vector>
+#include <memory_resource>
+
+namespace
+{
+    // One frame's transient data: a few dozen short vectors of points, as
+    // stroke pieces and damage lists come and go.
+    template <class Vector, class Make>
+    void frame(Make&& make) {
+        for (int piece = 0; piece < 32; ++piece) {
+            Vector v = make();
+            for (int i = 0; i < 64 + piece * 8; ++i) {
+                v.push_back({static_cast<float>(i), static_cast<float>(piece)});
+            }
+            benchmark::DoNotOptimize(v.data());
+        }
+    }
+}
+
+static void arena_global_heap(benchmark::State& state) {
+    for (auto _ : state) {
+        frame<std::vector<aux::versor<float, 2>>>([] { return std::vector<aux::versor<float, 2>>{}; });
+    }
+}
+BENCHMARK(arena_global_heap);
+
+static void arena_frame(benchmark::State& state) {
+    aux::frame_arena arena;
+    for (auto _ : state) {
+        frame<std::pmr::vector<aux::versor<float, 2>>>([&] { return std::pmr::vector<aux::versor<float, 2>>{&arena}; });
+        arena.reset();
+    }
+}
+BENCHMARK(arena_frame);
+
+static void arena_size_classes(benchmark::State& state) {
+    aux::size_class_pool pool;
+    for (auto _ : state) {
+        frame<std::pmr::vector<aux::versor<float, 2>>>([&] { return std::pmr::vector<aux::versor<float, 2>>{&pool}; });
+    }
+}
+BENCHMARK(arena_size_classes);
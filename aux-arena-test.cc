@@ -0,0 +1,160 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/arena.hpp>
+#include <aux/versor.hpp>
+#include <aux/packed-tuple.hpp>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <memory_resource>
+#include <algorithm>
+
+// the whole test program counts its heap allocations
+AUX_COUNT_HEAP_ALLOCATIONS()
+
+class aux_arena_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+TEST_F(aux_arena_test, bump) {
+    aux::frame_arena arena{4096};
+    auto a = arena.allocate(10, 1);
+    auto b = arena.allocate(8, 8);
+    auto c = arena.allocate(64, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0);
+    ASSERT_GE(static_cast<std::byte*>(b), static_cast<std::byte*>(a) + 10);
+    ASSERT_GE(static_cast<std::byte*>(c), static_cast<std::byte*>(b) + 8);
+    ASSERT_EQ(arena.upstream_allocations(), 1);
+    ASSERT_GE(arena.used(), 82);
+
+    arena.reset();
+    ASSERT_EQ(arena.used(), 0);
+    ASSERT_EQ(arena.allocate(10, 1), a);
+    ASSERT_EQ(arena.upstream_allocations(), 1);
+
+    // larger than a block: a block of its own, kept for the next frame
+    auto big = arena.allocate(10000, 16);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(big) % 16, 0);
+    ASSERT_EQ(arena.upstream_allocations(), 2);
+    arena.reset();
+    static_cast<void>(arena.allocate(10, 1));
+    ASSERT_EQ(arena.allocate(10000, 16), big);
+    ASSERT_EQ(arena.upstream_allocations(), 2);
+    ASSERT_GE(arena.high_water(), 10010);
+}
+
+TEST_F(aux_arena_test, frames) {
+    // a frame's worth of containers of versors and packed tuples
+    aux::frame_arena arena{1 << 16};
+    using sample = aux::packed_tuple<uint32_t, uint16_t, float, float>;
+    size_t blocks = 0;
+    size_t heap = 0;
+    for (int frame = 0; frame < 100; ++frame) {
+        if (frame == 10) {
+            blocks = arena.upstream_allocations();
+            heap = aux::heap_allocations();
+        }
+        {
+            std::pmr::vector<aux::versor<float, 2>> points{&arena};
+            std::pmr::vector<sample> samples{&arena};
+            for (int i = 0; i < 1000 + frame % 7 * 100; ++i) {
+                points.push_back({static_cast<float>(i), static_cast<float>(frame)});
+                samples.push_back({static_cast<uint32_t>(i), uint16_t{1}, 0.5f, 0.25f});
+            }
+            ASSERT_EQ(get<0>(points[999]), 999.0f);
+            ASSERT_EQ(get<0>(std::as_const(samples)[999]), 999);
+        }
+        arena.reset();
+    }
+    ASSERT_EQ(arena.upstream_allocations(), blocks);
+    if (aux::heap_counting()) {
+        ASSERT_EQ(aux::heap_allocations(), heap);
+    }
+}
+
+TEST_F(aux_arena_test, size_classes) {
+    static_assert(aux::size_class_pool::block_size(1) == 16);
+    static_assert(aux::size_class_pool::block_size(17) == 32);
+    static_assert(aux::size_class_pool::block_size(4096) == 4096);
+    static_assert(aux::size_class_pool::block_size(aux::size_class_pool::max_block + 1) == 0);
+
+    aux::size_class_pool pool{4096};
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        auto p = pool.allocate(100, 8);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0);
+        for (auto q : blocks) {
+            auto d = static_cast<std::byte*>(p) - static_cast<std::byte*>(q);
+            ASSERT_TRUE(d >= 128 || d <= -128);
+        }
+        blocks.push_back(p);
+    }
+    ASSERT_EQ(pool.in_use(), 100);
+    auto slabs = pool.upstream_allocations();
+    ASSERT_EQ(slabs, 4);   // 32 blocks of 128 bytes a slab
+
+    // freed blocks are reused, last freed first
+    pool.deallocate(blocks[5], 100, 8);
+    ASSERT_EQ(pool.allocate(120, 8), blocks[5]);
+    for (auto p : blocks) pool.deallocate(p, 100, 8);
+    ASSERT_EQ(pool.in_use(), 0);
+    for (int i = 0; i < 100; ++i) static_cast<void>(pool.allocate(128, 16));
+    ASSERT_EQ(pool.upstream_allocations(), slabs);
+
+    // oversized and over-aligned requests pass through
+    auto huge = pool.allocate(aux::size_class_pool::max_block + 1, 8);
+    auto aligned = pool.allocate(64, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+    ASSERT_EQ(pool.upstream_allocations(), slabs + 2);
+    pool.deallocate(huge, aux::size_class_pool::max_block + 1, 8);
+    pool.deallocate(aligned, 64, 64);
+}
+
+TEST_F(aux_arena_test, chunks) {
+    // long-lived pieces of a few sizes, built from arena data
+    aux::size_class_pool pool;
+    aux::frame_arena arena;
+    std::pmr::vector<std::pmr::vector<aux::versor<float, 3>>> pieces{&pool};
+    size_t heap = 0;
+    for (int frame = 0; frame < 50; ++frame) {
+        if (frame == 10) heap = aux::heap_allocations();
+        std::pmr::vector<aux::versor<float, 3>> fresh{&arena};
+        fresh.resize(static_cast<size_t>(64 << (frame % 3)));
+        pieces.emplace_back(fresh.begin(), fresh.end());
+        if (pieces.size() > 8) pieces.erase(pieces.begin());
+        arena.reset();
+    }
+    ASSERT_EQ(pieces.size(), 8);
+    ASSERT_EQ(pieces.front().get_allocator().resource(), &pool);
+    if (aux::heap_counting()) {
+        ASSERT_EQ(aux::heap_allocations(), heap);
+    }
+}
+
+TEST_F(aux_arena_test, counter) {
+    ASSERT_TRUE(aux::heap_counting());
+    auto before = aux::heap_allocations();
+    auto p = std::make_unique<int>(1);
+    ASSERT_EQ(aux::heap_allocations(), before + 1);
+}
+
+TEST_F(aux_arena_test, counter_nothrow) {
+    auto before = aux::heap_allocations();
+    auto p = std::unique_ptr<int>{new (std::nothrow) int{1}};
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(aux::heap_allocations(), before + 1);
+
+    // std::stable_sort takes its buffer with new (std::nothrow)
+    std::array<int, 1000> v;
+    for (size_t i = 0; i < v.size(); ++i) v[i] = static_cast<int>((i * 7919) % 1000);
+    before = aux::heap_allocations();
+    std::stable_sort(v.begin(), v.end());
+    ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+    ASSERT_EQ(aux::heap_allocations(), before + 1);
+}
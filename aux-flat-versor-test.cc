@@ -0,0 +1,100 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/flat-versor.hpp>
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include <spanstream>
+#include <string>
+
+class aux_flat_versor_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+TEST_F(aux_flat_versor_test, layout) {
+    {
+        using vertex = aux::flat_versor<float, 4, 16>;
+        static_assert(std::is_trivially_copyable_v<vertex>);
+        static_assert(std::is_standard_layout_v<vertex>);
+        static_assert(sizeof (vertex) == 4 * sizeof (float));
+        static_assert(alignof (vertex) == 16);
+
+        std::vector<vertex> vertices;
+        for (int i = 0; i < 64; ++i) {
+            vertices.push_back({float(i), float(i) + 0.25f, float(-i), 1.0f});
+        }
+        std::vector<float> mapped(vertices.size() * 4);
+        std::memcpy(mapped.data(), vertices.data(), vertices.size() * sizeof (vertex));
+        ASSERT_EQ(mapped[4 * 10 + 0], 10.0f);
+        ASSERT_EQ(mapped[4 * 10 + 1], 10.25f);
+        ASSERT_EQ(mapped[4 * 63 + 2], -63.0f);
+        ASSERT_EQ(mapped[4 * 63 + 3], 1.0f);
+    }
+}
+
+TEST_F(aux_flat_versor_test, initializer) {
+    {
+        constexpr aux::flat_versor<int, 3> v{1, 2};
+        static_assert(get<0>(v) == 1);
+        static_assert(get<1>(v) == 2);
+        static_assert(get<2>(v) == 0);
+        static_assert(v[1] == 2);
+        ASSERT_EQ(v.at(2), 0);
+        ASSERT_THROW(v.at(3), std::range_error);
+    }
+    {
+        // no more components than N, each one convertible to T
+        static_assert(std::is_constructible_v<aux::flat_versor<float, 2>, int, double>);
+        static_assert(!std::is_constructible_v<aux::flat_versor<float, 2>, float, float, float>);
+        static_assert(!std::is_constructible_v<aux::flat_versor<float, 2>, char const*>);
+        static_assert(!std::is_convertible_v<std::string, aux::flat_versor<float, 2>>);
+    }
+    {
+        constexpr aux::versor<double, 3> v{1.5, 2.5, 3.5};
+        constexpr aux::flat_versor<double, 3> f = v;
+        constexpr aux::versor<double, 3> back = f;
+        static_assert(get<2>(f) == 3.5);
+        static_assert(back == v);
+    }
+    {
+        aux::flat_versor<char, 3> v{'a', 'b', 'c'};
+        std::array<char, 32> buf{};
+        std::spanstream output{buf};
+        output << v;
+        ASSERT_STREQ("(a b c)", output.span().data());
+        auto [x, y, z] = v;
+        ASSERT_EQ(x, 'a');
+        ASSERT_EQ(z, 'c');
+    }
+}
+
+TEST_F(aux_flat_versor_test, algebra) {
+    {
+        constexpr aux::flat_versor<double, 4, 32> v{1, 2, 3, 4};
+        static_assert(v * 2.0 == v + v);
+        static_assert(v - v == aux::flat_versor<double, 4, 32>{});
+        static_assert(v / 2.0 == aux::flat_versor<double, 4, 32>{0.5, 1, 1.5, 2});
+        static_assert(-v == v - v * 2.0);
+        static_assert(inner(v, v) == 30.0);
+
+        auto x = v;
+        ASSERT_TRUE(x * 2.0 == x + x);
+        ASSERT_TRUE(x * x == v * v);
+        ASSERT_EQ(inner(x, x), 30.0);
+        ASSERT_EQ(norm(aux::flat_versor<float, 2>{3, 4}), 5.0f);
+        ASSERT_TRUE((aux::versor<double, 4>(x) * 2.0 == aux::versor<double, 4>(x + x)));
+    }
+    {
+        constexpr aux::flat_versor<uint8_t, 4> a{0x0f, 0xf0, 0xff, 0x00};
+        constexpr aux::flat_versor<uint8_t, 4> b{0xf0, 0x0f, 0x00, 0xff};
+        static_assert((a | b) == aux::flat_versor<uint8_t, 4>{0xff, 0xff, 0xff, 0xff});
+        static_assert(~a == b);
+        auto x = a;
+        ASSERT_TRUE((x ^ b) == (a | b));
+        ASSERT_TRUE(x + b == (aux::flat_versor<uint8_t, 4>{0xff, 0xff, 0xff, 0xff}));
+    }
+}
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <aux/intersection.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Ink-like input: random walks of short segments over a 4K canvas, so
+    // the number of crossings grows about linearly with the segment count.
+    std::vector<aux::segment> ink_segments(size_t n) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<double> x{0.0, 3840.0}, y{0.0, 2160.0}, angle{-0.6, 0.6};
+        std::vector<aux::segment> ret;
+        while (ret.size() < n) {
+            aux::versor<double, 2> p{x(gen), y(gen)};
+            double heading = angle(gen) * 5;
+            for (size_t i = 0; i < 256 && ret.size() < n; ++i) {
+                heading += angle(gen);
+                aux::versor<double, 2> q = p + aux::versor<double, 2>{4 * std::cos(heading), 4 * std::sin(heading)};
+                ret.push_back({p, q});
+                p = q;
+            }
+        }
+        return ret;
+    }
+
+    void intersect_naive(benchmark::State& state) {
+        auto segments = ink_segments(static_cast<size_t>(state.range(0)));
+        size_t found = 0;
+        for (auto _ : state) {
+            found = aux::intersections_naive(segments).size();
+            benchmark::DoNotOptimize(found);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * segments.size()));
+        state.counters["pairs"] = static_cast<double>(found);
+    }
+
+    void intersect_sweep(benchmark::State& state) {
+        auto segments = ink_segments(static_cast<size_t>(state.range(0)));
+        aux::sweep_line sweep;
+        size_t found = 0;
+        for (auto _ : state) {
+            found = sweep(segments).size();
+            benchmark::DoNotOptimize(found);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * segments.size()));
+        state.counters["pairs"] = static_cast<double>(found);
+    }
+
+    void intersect_strips(benchmark::State& state) {
+        auto segments = ink_segments(1 << 18);
+        aux::thread_pool pool{static_cast<size_t>(state.range(0))};
+        size_t found = 0;
+        for (auto _ : state) {
+            found = aux::intersections(segments, pool).size();
+            benchmark::DoNotOptimize(found);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * segments.size()));
+        state.counters["pairs"] = static_cast<double>(found);
+    }
+} // namespace
+
+BENCHMARK(intersect_naive)->RangeMultiplier(4)->Range(1 << 10, 1 << 14)->Unit(benchmark::kMillisecond);
+BENCHMARK(intersect_sweep)->RangeMultiplier(4)->Range(1 << 10, 1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(intersect_strips)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
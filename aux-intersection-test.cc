@@ -0,0 +1,113 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/intersection.hpp>
+
+#include <random>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
+class aux_intersection_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+namespace
+{
+    using pairs = std::vector<std::tuple<uint32_t, uint32_t, double, double>>;
+
+    pairs sorted(std::vector<aux::intersection> const& found) {
+        pairs ret;
+        for (auto const& i : found) ret.emplace_back(i.first, i.second, get<0>(i.point), get<1>(i.point));
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+    std::vector<aux::segment> random_segments(size_t n, double length, std::mt19937& gen) {
+        std::uniform_real_distribution<double> pos{0.0, 1000.0}, step{-length, length};
+        std::vector<aux::segment> ret;
+        for (size_t i = 0; i < n; ++i) {
+            aux::versor<double, 2> a{pos(gen), pos(gen)};
+            ret.push_back({a, a + aux::versor<double, 2>{step(gen), step(gen)}});
+        }
+        return ret;
+    }
+
+    // Small integer lattice: shared endpoints, verticals, horizontals,
+    // collinear overlaps, points and many segments through one point.
+    std::vector<aux::segment> lattice_segments(size_t n, std::mt19937& gen) {
+        std::uniform_int_distribution<int> pos{0, 6};
+        std::vector<aux::segment> ret;
+        for (size_t i = 0; i < n; ++i) {
+            ret.push_back({{pos(gen), pos(gen)}, {pos(gen), pos(gen)}});
+        }
+        return ret;
+    }
+} // namespace
+
+TEST_F(aux_intersection_test, orientation) {
+    using v = aux::versor<double, 2>;
+    ASSERT_EQ(aux::orientation(v{0, 0}, v{1, 0}, v{0, 1}), 1);
+    ASSERT_EQ(aux::orientation(v{0, 0}, v{1, 0}, v{0, -1}), -1);
+    ASSERT_EQ(aux::orientation(v{0, 0}, v{1, 1}, v{3, 3}), 0);
+    // points near the line y = x sampled a few ulps apart; the naive
+    // determinant gets many of these wrong
+    for (int i = 0; i < 64; ++i) {
+        for (int k = 0; k < 64; ++k) {
+            v c{0.5 + i * 0x1p-53, 0.5 + k * 0x1p-53};
+            auto expected = (k > i) - (k < i);
+            ASSERT_EQ(aux::orientation(v{12, 12}, v{24, 24}, c), expected) << i << ' ' << k;
+        }
+    }
+}
+
+TEST_F(aux_intersection_test, classify) {
+    using aux::contact;
+    aux::segment s{{0, 0}, {4, 4}};
+    ASSERT_EQ(aux::classify(s, {{0, 4}, {4, 0}}), contact::cross);
+    ASSERT_EQ(aux::classify(s, {{2, 2}, {4, 0}}), contact::touch);
+    ASSERT_EQ(aux::classify(s, {{4, 4}, {5, 5}}), contact::touch);
+    ASSERT_EQ(aux::classify(s, {{3, 3}, {5, 5}}), contact::overlap);
+    ASSERT_EQ(aux::classify(s, {{5, 5}, {6, 6}}), contact::none);
+    ASSERT_EQ(aux::classify(s, {{1, 0}, {5, 4}}), contact::none);
+    ASSERT_EQ(aux::classify(s, {{1, 1}, {1, 1}}), contact::touch);
+    auto p = aux::contact_point(s, {{0, 4}, {4, 0}}, contact::cross);
+    ASSERT_EQ(p, (aux::versor<double, 2>{2, 2}));
+    ASSERT_EQ(aux::contact_point(s, {{5, 5}, {3, 3}}, contact::overlap), (aux::versor<double, 2>{3, 3}));
+}
+
+TEST_F(aux_intersection_test, random) {
+    std::mt19937 gen{7};
+    aux::sweep_line sweep;
+    for (auto length : {5.0, 40.0, 300.0}) {
+        auto segments = random_segments(800, length, gen);
+        auto expected = sorted(aux::intersections_naive(segments));
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQ(sorted(sweep(segments)), expected) << length;
+    }
+}
+
+TEST_F(aux_intersection_test, degenerate) {
+    std::mt19937 gen{11};
+    aux::sweep_line sweep;
+    for (int round = 0; round < 200; ++round) {
+        auto segments = lattice_segments(40, gen);
+        ASSERT_EQ(sorted(sweep(segments)), sorted(aux::intersections_naive(segments))) << round;
+    }
+}
+
+TEST_F(aux_intersection_test, parallel) {
+    std::mt19937 gen{13};
+    auto segments = random_segments(4000, 20.0, gen);
+    auto lattice = lattice_segments(300, gen);
+    auto expected = sorted(aux::intersections_naive(segments));
+    for (size_t threads : {1, 2, 4}) {
+        aux::thread_pool pool{threads};
+        for (size_t strips : {0, 3, 16}) {
+            ASSERT_EQ(sorted(aux::intersections(segments, pool, strips)), expected);
+        }
+        ASSERT_EQ(sorted(aux::intersections(lattice, pool, 8)), sorted(aux::intersections_naive(lattice)));
+    }
+}
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <aux/matrix.hpp>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    // a full document's worth of points
+    constexpr size_t points = 10'000'000;
+
+    template <size_t M>
+    std::vector<aux::versor<float, M>>& document() {
+        static auto ret = [] {
+            std::mt19937 gen{5};
+            std::uniform_real_distribution<float> pos{0.0f, 4000.0f};
+            std::vector<aux::versor<float, M>> v(points);
+            for (auto& p : v) {
+                for (auto& x : p) x = pos(gen);
+            }
+            return v;
+        }();
+        return ret;
+    }
+
+    aux::thread_pool& pool() {
+        static aux::thread_pool ret;
+        return ret;
+    }
+
+    // pan, zoom and rotate about a point
+    auto const view = aux::translation(aux::versor<float, 2>{640, 360}) * aux::rotation(0.01f) *
+        aux::scaling(1.001f) * aux::translation(aux::versor<float, 2>{-640, -360});
+
+    // the per-point operator* in a loop, for reference
+    template <size_t M>
+    void matrix_transform_scalar(benchmark::State& state) {
+        auto& v = document<M>();
+        for (auto _ : state) {
+            for (auto& p : v) p = view * p;
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points));
+    }
+
+    template <size_t M>
+    void matrix_transform(benchmark::State& state) {
+        auto& v = document<M>();
+        for (auto _ : state) {
+            aux::transform(view, std::span{v});
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points));
+    }
+
+    template <size_t M>
+    void matrix_transform_pool(benchmark::State& state) {
+        auto& v = document<M>();
+        for (auto _ : state) {
+            aux::transform(pool(), view, std::span{v});
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points));
+        state.SetLabel(std::to_string(pool().concurrency()) + " threads");
+    }
+
+    void matrix_project_pool(benchmark::State& state) {
+        auto& v = document<3>();
+        auto h = aux::homogeneous(view);
+        for (auto _ : state) {
+            aux::project(pool(), h, std::span{v});
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points));
+    }
+} // namespace
+
+BENCHMARK(matrix_transform_scalar<2>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(matrix_transform<2>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(matrix_transform_pool<2>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(matrix_transform_scalar<3>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(matrix_transform<3>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(matrix_transform_pool<3>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(matrix_project_pool)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,118 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/matrix.hpp>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+class aux_matrix_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+namespace
+{
+    template <size_t M>
+    std::vector<aux::versor<float, M>> random_points(size_t n) {
+        std::mt19937 gen{23};
+        std::uniform_real_distribution<float> pos{-1000.0f, 1000.0f};
+        std::vector<aux::versor<float, M>> ret(n);
+        for (auto& p : ret) {
+            for (auto& x : p) x = pos(gen);
+        }
+        return ret;
+    }
+} // namespace
+
+TEST_F(aux_matrix_test, constexpr_composition) {
+    using aux::matrix2x3;
+    constexpr matrix2x3<float> identity;
+    static_assert(identity == matrix2x3<float>{{1, 0, 0}, {0, 1, 0}});
+    constexpr auto m = aux::translation(aux::versor<float, 2>{10, -5}) * aux::scaling(2.0f);
+    static_assert(m == matrix2x3<float>{{2, 0, 10}, {0, 2, -5}});
+    static_assert(m * aux::versor<float, 2>{1, 1} == aux::versor<float, 2>{12, -3});
+    static_assert(m * identity == m && identity * m == m);
+    static_assert(aux::determinant(m) == 4);
+    static_assert(aux::inverse(m) * m == identity);
+    // the third component passes through
+    static_assert(m * aux::versor<float, 3>{1, 1, 0.5f} == aux::versor<float, 3>{12, -3, 0.5f});
+
+    constexpr aux::matrix4x4<double> a{{1, 2, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 3}, {0, 0, 0, 1}};
+    constexpr aux::matrix4x4<double> b{{0, 1, 0, 0}, {1, 0, 0, 0}, {0, 0, 2, 0}, {0, 0, 0, 1}};
+    static_assert(a * b == aux::matrix4x4<double>{{2, 1, 0, 0}, {1, 0, 0, 0}, {0, 0, 2, 3}, {0, 0, 0, 1}});
+    static_assert(aux::transpose(aux::transpose(a)) == a);
+    static_assert(aux::project(a, aux::versor<double, 3>{1, 1, 1}) == aux::versor<double, 3>{3, 1, 4});
+    static_assert(aux::homogeneous(m)[2] == aux::versor<float, 3>{0, 0, 1});
+}
+
+TEST_F(aux_matrix_test, inverse) {
+    auto m = aux::translation(aux::versor<float, 2>{3, 4}) * aux::rotation(0.5f) * aux::scaling(aux::versor<float, 2>{2.0f, 0.5f});
+    auto p = aux::versor<float, 2>{7, -2};
+    auto q = aux::inverse(m) * (m * p);
+    ASSERT_NEAR(get<0>(q), get<0>(p), 1e-4f);
+    ASSERT_NEAR(get<1>(q), get<1>(p), 1e-4f);
+
+    aux::matrix3x3<double> h{{2, 1, 0}, {0, 1, 4}, {0.5, 0, 1}};
+    auto i = aux::inverse(h) * h;
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) ASSERT_NEAR(i[r][c], r == c ? 1.0 : 0.0, 1e-12);
+    }
+
+    // counterclockwise in y-up
+    auto r = aux::rotation(std::numbers::pi_v<double> / 2) * aux::versor<double, 2>{1, 0};
+    ASSERT_NEAR(get<0>(r), 0.0, 1e-12);
+    ASSERT_NEAR(get<1>(r), 1.0, 1e-12);
+}
+
+TEST_F(aux_matrix_test, transform_span) {
+    auto m = aux::translation(aux::versor<float, 2>{10, -5}) * aux::rotation(0.3f) * aux::scaling(1.5f);
+    aux::thread_pool pool{4};
+    auto check = [&]<size_t M>(std::vector<aux::versor<float, M>> const& in) {
+        std::vector<aux::versor<float, M>> out(in.size());
+        aux::transform(m, in, std::span{out});
+        auto pooled = in;
+        aux::transform(pool, m, std::span{pooled});
+        for (size_t i = 0; i < in.size(); ++i) {
+            auto expected = m * in[i];
+            for (size_t c = 0; c < M; ++c) {
+                ASSERT_EQ(out[i][c], expected[c]) << M << " " << i << " " << c;
+                ASSERT_EQ(pooled[i][c], expected[c]) << M << " " << i << " " << c;
+            }
+        }
+    };
+    for (size_t n : {0, 1, 2, 3, 5, 1000, 100'003}) {
+        check(random_points<2>(n));
+        check(random_points<3>(n));
+        check(random_points<4>(n));
+        check(random_points<5>(n));
+    }
+
+    // 3D affine of 3D points
+    aux::matrix<float, 3, 4> s{{0, 1, 0, 1}, {-1, 0, 0, 2}, {0, 0, 2, 3}};
+    auto in = random_points<3>(1001);
+    auto out = in;
+    aux::transform(s, std::span{out});
+    for (size_t i = 0; i < in.size(); ++i) {
+        ASSERT_FLOAT_EQ(get<0>(out[i]), get<1>(in[i]) + 1);
+        ASSERT_FLOAT_EQ(get<1>(out[i]), -get<0>(in[i]) + 2);
+        ASSERT_FLOAT_EQ(get<2>(out[i]), 2 * get<2>(in[i]) + 3);
+    }
+}
+
+TEST_F(aux_matrix_test, project_span) {
+    aux::matrix3x3<float> h{{1, 0, 0}, {0, 1, 0}, {0.001f, 0, 1}};
+    auto in = random_points<3>(10'007);
+    auto out = in;
+    aux::thread_pool pool{3};
+    aux::project(pool, h, std::span{out});
+    for (size_t i = 0; i < in.size(); ++i) {
+        auto w = 0.001f * get<0>(in[i]) + 1;
+        ASSERT_FLOAT_EQ(get<0>(out[i]), get<0>(in[i]) / w);
+        ASSERT_FLOAT_EQ(get<1>(out[i]), get<1>(in[i]) / w);
+        ASSERT_EQ(get<2>(out[i]), get<2>(in[i]));
+    }
+}
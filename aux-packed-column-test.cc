@@ -0,0 +1,98 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/packed-column.hpp>
+
+#include <vector>
+
+class aux_packed_column_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+
+    using record = aux::packed_tuple<double, char, int>;
+
+    static auto make_records(size_t n) {
+        std::vector<record> ret;
+        for (size_t i = 0; i < n; ++i) {
+            ret.emplace_back(i * 0.5, static_cast<char>('a' + i % 26), static_cast<int>(i * 7));
+        }
+        return ret;
+    }
+};
+
+TEST_F(aux_packed_column_test, offset) {
+    static_assert(aux::packed_offset<0, double, char, int> == 0);
+    static_assert(aux::packed_offset<1, double, char, int> == 8);
+    static_assert(aux::packed_offset<2, double, char, int> == 9);
+    static_assert(std::is_same_v<aux::packed_field_t<2, double, char, int>, int>);
+}
+
+TEST_F(aux_packed_column_test, gather) {
+    for (size_t n : {0, 1, 15, 16, 17, 1000}) {
+        auto records = make_records(n);
+        std::vector<double> timestamps(n);
+        std::vector<char> tools(n);
+        std::vector<int> pressures(n);
+        aux::gather<0>(std::span{records}, std::span{timestamps});
+        aux::gather<1>(std::span{records}, std::span{tools});
+        aux::gather<2>(std::span{records}, std::span{pressures});
+        for (size_t i = 0; i < n; ++i) {
+            auto const& r = records[i];
+            ASSERT_EQ(timestamps[i], get<0>(r));
+            ASSERT_EQ(tools[i], get<1>(r));
+            ASSERT_EQ(pressures[i], get<2>(r));
+        }
+    }
+}
+
+TEST_F(aux_packed_column_test, scatter) {
+    auto records = make_records(100);
+    std::vector<int> pressures(100);
+    for (size_t i = 0; i < pressures.size(); ++i) {
+        pressures[i] = -static_cast<int>(i);
+    }
+    aux::scatter<2>(std::span<int const>{pressures}, std::span{records});
+    for (size_t i = 0; i < records.size(); ++i) {
+        auto const& r = records[i];
+        ASSERT_EQ(get<0>(r), i * 0.5);
+        ASSERT_EQ(get<1>(r), static_cast<char>('a' + i % 26));
+        ASSERT_EQ(get<2>(r), -static_cast<int>(i));
+    }
+}
+
+TEST_F(aux_packed_column_test, unaligned) {
+    // records read straight out of a byte buffer at an odd address
+    auto records = make_records(40);
+    std::vector<std::byte> wire(1 + records.size() * sizeof (record));
+    std::memcpy(wire.data() + 1, records.data(), wire.size() - 1);
+    std::span<record const> view{reinterpret_cast<record const*>(wire.data() + 1), records.size()};
+
+    std::vector<int> pressures(records.size());
+    aux::gather<2>(view, std::span{pressures});
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQ(pressures[i], static_cast<int>(i * 7));
+    }
+}
+
+TEST_F(aux_packed_column_test, mismatched_sizes) {
+    // only the shorter of the two spans is copied
+    auto records = make_records(20);
+    std::vector<int> pressures(30, -1);
+    aux::gather<2>(std::span{records}, std::span{pressures});
+    for (size_t i = 0; i < pressures.size(); ++i) {
+        ASSERT_EQ(pressures[i], i < records.size() ? static_cast<int>(i * 7) : -1);
+    }
+
+    std::vector<int> fewer(5, 0);
+    aux::scatter<2>(std::span<int const>{fewer}, std::span{records});
+    for (size_t i = 0; i < records.size(); ++i) {
+        auto const& r = records[i];
+        ASSERT_EQ(get<2>(r), i < fewer.size() ? 0 : static_cast<int>(i * 7));
+    }
+
+    std::vector<double> timestamps(records.size(), -1.0);
+    aux::gather<0>(std::span{records}.first(10), std::span{timestamps});
+    ASSERT_EQ(timestamps[9], 4.5);
+    ASSERT_EQ(timestamps[10], -1.0);
+}
@@ -0,0 +1,87 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/persistent-vector.hpp>
+#include <aux/versor.hpp>
+
+#include <vector>
+#include <numeric>
+#include <unordered_set>
+
+class aux_persistent_vector_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+TEST_F(aux_persistent_vector_test, basic) {
+    aux::persistent_vector<int, 4, 4> v;
+    ASSERT_TRUE(v.empty());
+    for (int i = 0; i < 100; ++i) v.push_back(i);
+    ASSERT_EQ(v.size(), 100);
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(v[i], i);
+    ASSERT_THROW(static_cast<void>(v.at(100)), std::out_of_range);
+
+    std::vector<int> more(37);
+    std::iota(more.begin(), more.end(), 100);
+    v.append(more);
+    ASSERT_EQ(v.size(), 137);
+    ASSERT_EQ(v[136], 136);
+
+    v.set(5, -5);
+    ASSERT_EQ(v[5], -5);
+    v.resize(10);
+    ASSERT_EQ(v.size(), 10);
+    v.resize(12);
+    ASSERT_EQ(v[11], 0);
+
+    std::vector<int> seen;
+    v.for_each_span(2, 11, [&](std::span<int const> s) {
+        ASSERT_LE(s.size(), 4);
+        seen.insert(seen.end(), s.begin(), s.end());
+    });
+    ASSERT_EQ(seen, (std::vector<int>{2, 3, 4, -5, 6, 7, 8, 9, 0}));
+}
+
+TEST_F(aux_persistent_vector_test, snapshots) {
+    aux::persistent_vector<int, 8, 4> v;
+    for (int i = 0; i < 1000; ++i) v.push_back(i);
+    auto snapshot = v;
+    ASSERT_TRUE(snapshot.same_storage(v));
+
+    v.set(500, -1);
+    v.push_back(1000);
+    ASSERT_FALSE(snapshot.same_storage(v));
+    ASSERT_EQ(snapshot[500], 500);
+    ASSERT_EQ(snapshot.size(), 1000);
+    ASSERT_EQ(v[500], -1);
+    ASSERT_EQ(v[1000], 1000);
+
+    // the two share all but the touched chunks and their paths
+    std::unordered_set<void const*> seen;
+    auto alone = snapshot.memory(seen);
+    auto extra = v.memory(seen);
+    ASSERT_GT(alone, 1000 * sizeof (int));
+    ASSERT_LT(extra, alone / 4);
+
+    // writes to an unshared copy stay in place
+    auto before = extra;
+    std::unordered_set<void const*> again;
+    snapshot.memory(again);
+    v.set(501, -2);
+    ASSERT_EQ(v.memory(again), before);
+    ASSERT_EQ(snapshot[501], 501);
+}
+
+TEST_F(aux_persistent_vector_test, modify) {
+    aux::persistent_vector<aux::versor<float, 2>, 16> v;
+    for (int i = 0; i < 100; ++i) v.push_back({static_cast<float>(i), 0.0f});
+    auto snapshot = v;
+    v.modify(10, 40, [](std::span<aux::versor<float, 2>> s) {
+        for (auto& p : s) p += aux::versor<float, 2>{0.0f, 1.0f};
+    });
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(get<1>(v[i]), i >= 10 && i < 40 ? 1.0f : 0.0f);
+        ASSERT_EQ(get<1>(snapshot[i]), 0.0f);
+    }
+}
@@ -0,0 +1,70 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/record-file.hpp>
+
+#include <string>
+#include <vector>
+
+class aux_record_file_test : public testing::Test {
+protected:
+    void SetUp() override {
+        path = testing::TempDir() + "aux-record-file-test.rec";
+    }
+    void TearDown() override {
+        ::unlink(path.c_str());
+    }
+
+    using record = aux::packed_tuple<double, char, int>;
+    std::string path;
+};
+
+TEST_F(aux_record_file_test, header) {
+    constexpr auto header = aux::make_record_file_header<double, char, int>(3);
+    static_assert(header.record_size == 13);
+    static_assert(header.field_count == 3);
+    static_assert(header.field_types[0] == 0x38);
+    static_assert(header.field_types[1] == 0x41);
+    static_assert(header.field_types[2] == 0x14);
+    static_assert(header.record_count == 3);
+}
+
+TEST_F(aux_record_file_test, round_trip) {
+    {
+        aux::record_writer<double, char, int> writer{path.c_str(), 64};
+        writer.append(record{0.5, 'p', 100});
+        std::vector<record> batch;
+        for (int i = 0; i < 1000; ++i) {
+            batch.emplace_back(i * 0.25, 'q', i);
+        }
+        writer.append(std::span<record const>{batch});
+        writer.append(record{-1.0, 'e', -1});
+        ASSERT_EQ(writer.size(), 1002);
+    }
+    {
+        aux::record_file<double, char, int> file{path.c_str()};
+        ASSERT_EQ(file.header().record_count, 1002);
+        ASSERT_EQ(file.size(), 1002);
+        ASSERT_EQ(get<0>(file[0]), 0.5);
+        ASSERT_EQ(get<1>(file[0]), 'p');
+        ASSERT_EQ(get<2>(file[0]), 100);
+        ASSERT_EQ(get<0>(file[501]), 500 * 0.25);
+        ASSERT_EQ(get<2>(file[501]), 500);
+        ASSERT_EQ(get<1>(file[1001]), 'e');
+
+        int sum = 0;
+        for (auto const& r : file) {
+            sum += get<2>(r);
+        }
+        ASSERT_EQ(sum, 100 + 999 * 1000 / 2 - 1);
+    }
+}
+
+TEST_F(aux_record_file_test, layout_mismatch) {
+    {
+        aux::record_writer<double, char, int> writer{path.c_str()};
+        writer.append(record{});
+    }
+    ASSERT_THROW((aux::record_file<float, char, int>{path.c_str()}), std::runtime_error);
+    ASSERT_THROW((aux::record_file<double, char, int>{"/nonexistent/file.rec"}), std::system_error);
+}
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <aux/soa-kernels.hpp>
+
+#include <random>
+
+namespace
+{
+    constexpr size_t elements = 1 << 22;
+
+    aux::compute& device() {
+        static aux::compute ret;
+        return ret;
+    }
+
+    void soa_transform(benchmark::State& state) {
+        aux::versor_soa<float, 2> points(elements, {1.0f, 2.0f});
+        aux::affine2 m{{0.8f, -0.6f, 1.0f}, {0.6f, 0.8f, -1.0f}};
+        for (auto _ : state) {
+            aux::transform(device(), points, m);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * elements));
+        state.SetLabel(device().device());
+    }
+
+    void soa_bounds(benchmark::State& state) {
+        std::mt19937 gen{1};
+        std::uniform_real_distribution<float> pos{0.0f, 4000.0f};
+        aux::versor_soa<float, 2> points;
+        points.reserve(elements);
+        for (size_t i = 0; i < elements; ++i) points.push_back({pos(gen), pos(gen)});
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(aux::bounds(device(), points));
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * elements));
+        state.SetLabel(device().device());
+    }
+
+    void soa_blend(benchmark::State& state) {
+        aux::versor_soa<float, 4> dst(elements, {0.2f, 0.3f, 0.4f, 1.0f});
+        aux::versor_soa<float, 4> src(elements, {0.1f, 0.1f, 0.1f, 0.5f});
+        for (auto _ : state) {
+            aux::blend(device(), dst, src);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * elements));
+        state.SetLabel(device().device());
+    }
+} // namespace
+
+BENCHMARK(soa_transform)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(soa_bounds)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(soa_blend)->UseRealTime()->Unit(benchmark::kMillisecond);
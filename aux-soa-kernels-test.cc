@@ -0,0 +1,85 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/soa-kernels.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+class aux_soa_kernels_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+namespace
+{
+    aux::versor_soa<float, 2> random_points(size_t n) {
+        std::mt19937 gen{17};
+        std::uniform_real_distribution<float> pos{-1000.0f, 1000.0f};
+        aux::versor_soa<float, 2> ret;
+        for (size_t i = 0; i < n; ++i) ret.push_back({pos(gen), pos(gen)});
+        return ret;
+    }
+
+    aux::versor_soa<float, 4> random_colors(size_t n, unsigned seed) {
+        std::mt19937 gen{seed};
+        std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+        aux::versor_soa<float, 4> ret;
+        for (size_t i = 0; i < n; ++i) {
+            auto a = unit(gen);
+            ret.push_back({unit(gen) * a, unit(gen) * a, unit(gen) * a, a});
+        }
+        return ret;
+    }
+} // namespace
+
+TEST_F(aux_soa_kernels_test, transform) {
+    aux::compute device;
+    ASSERT_FALSE(device.device().empty());
+    for (size_t n : {0, 1, 1000, 100'003}) {
+        auto points = random_points(n);
+        auto expected = points;
+        aux::affine2 m{{0.8f, -0.6f, 10.0f}, {0.6f, 0.8f, -5.0f}};
+        aux::transform(device, points, m);
+        for (size_t i = 0; i < n; ++i) {
+            aux::versor<float, 2> p = expected[i];
+            ASSERT_FLOAT_EQ(get<0>(points[i]), 0.8f * get<0>(p) - 0.6f * get<1>(p) + 10.0f);
+            ASSERT_FLOAT_EQ(get<1>(points[i]), 0.6f * get<0>(p) + 0.8f * get<1>(p) - 5.0f);
+        }
+    }
+}
+
+TEST_F(aux_soa_kernels_test, bounds) {
+    aux::compute device;
+    auto [elo, ehi] = aux::bounds(device, aux::versor_soa<float, 2>{});
+    ASSERT_GT(get<0>(elo), get<0>(ehi));
+    for (size_t n : {1, 7, 100'003}) {
+        auto points = random_points(n);
+        aux::versor<float, 2> lo = points[0], hi = points[0];
+        for (size_t i = 0; i < n; ++i) {
+            lo = aux::min(lo, static_cast<aux::versor<float, 2>>(points[i]));
+            hi = aux::max(hi, static_cast<aux::versor<float, 2>>(points[i]));
+        }
+        auto [l, h] = aux::bounds(device, points);
+        ASSERT_EQ(l, lo);
+        ASSERT_EQ(h, hi);
+    }
+}
+
+TEST_F(aux_soa_kernels_test, blend) {
+    aux::compute device;
+    for (size_t n : {0, 3, 70'001}) {
+        auto dst = random_colors(n, 1);
+        auto src = random_colors(n, 2);
+        auto expected = dst;
+        aux::blend(device, dst, src);
+        for (size_t i = 0; i < n; ++i) {
+            aux::versor<float, 4> s = src[i];
+            for (size_t c = 0; c < 4; ++c) {
+                ASSERT_FLOAT_EQ(dst[i][c], s[c] + expected[i][c] * (1 - get<3>(s)));
+            }
+        }
+    }
+}
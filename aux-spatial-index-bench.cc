@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <aux/spatial-index.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // A document of 10^6 ink segments (random walks of 4 px steps over a
+    // 4K canvas), committed to the tree.
+    constexpr size_t segments = 1'000'000;
+
+    std::vector<aux::bounding_box> ink_boxes(size_t n) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<float> x{0.0f, 3840.0f}, y{0.0f, 2160.0f}, turn{-0.6f, 0.6f};
+        std::vector<aux::bounding_box> ret;
+        while (ret.size() < n) {
+            aux::versor<float, 2> p{x(gen), y(gen)};
+            float heading = turn(gen) * 5;
+            for (size_t i = 0; i < 256 && ret.size() < n; ++i) {
+                heading += turn(gen);
+                aux::versor<float, 2> q = p + aux::versor<float, 2>{4 * std::cos(heading), 4 * std::sin(heading)};
+                ret.push_back({min(p, q), max(p, q)});
+                p = q;
+            }
+        }
+        return ret;
+    }
+
+    aux::spatial_index& document() {
+        static auto index = [] {
+            aux::spatial_index ret;
+            auto boxes = ink_boxes(segments);
+            for (uint32_t i = 0; i < boxes.size(); ++i) ret.insert(i, boxes[i]);
+            ret.commit();
+            return ret;
+        }();
+        return index;
+    }
+
+    void spatial_index_commit(benchmark::State& state) {
+        auto boxes = ink_boxes(segments);
+        aux::spatial_index index;
+        for (auto _ : state) {
+            state.PauseTiming();
+            for (uint32_t i = 0; i < boxes.size(); ++i) index.insert(i, boxes[i]);
+            state.ResumeTiming();
+            index.commit();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * boxes.size()));
+    }
+
+    template <int Kind>
+    void spatial_index_query(benchmark::State& state) {
+        auto& index = document();
+        std::mt19937 gen{7};
+        std::uniform_real_distribution<float> x{0.0f, 3840.0f}, y{0.0f, 2160.0f};
+        size_t hits = 0;
+        for (auto _ : state) {
+            aux::versor<float, 2> p{x(gen), y(gen)};
+            auto count = [&hits](uint32_t) { ++hits; };
+            if constexpr (Kind == 0) index.query(p, count);
+            if constexpr (Kind == 1) index.query(p, 12.0f, count);
+            if constexpr (Kind == 2) index.query({p, p + aux::versor<float, 2>{100.0f, 100.0f}}, count);
+        }
+        state.counters["hits"] = benchmark::Counter(static_cast<double>(hits), benchmark::Counter::kAvgIterations);
+    }
+
+    // One input frame of a pen stroke: a few new segments go into the
+    // grid and an eraser removes what it touches, over the committed tree.
+    void spatial_index_frame(benchmark::State& state) {
+        auto& index = document();
+        std::mt19937 gen{9};
+        std::uniform_real_distribution<float> step{-4.0f, 4.0f};
+        aux::versor<float, 2> pen{1920.0f, 1080.0f};
+        auto next = static_cast<uint32_t>(segments);
+        std::vector<uint32_t> erased;
+        for (auto _ : state) {
+            for (int k = 0; k < 8; ++k) {
+                auto q = pen + aux::versor<float, 2>{step(gen), step(gen)};
+                index.insert(next++, {min(pen, q), max(pen, q)});
+                pen = q;
+            }
+            erased.clear();
+            index.query(pen + aux::versor<float, 2>{200.0f, 0.0f}, 8.0f, [&](uint32_t id) { erased.push_back(id); });
+            for (auto id : erased) index.remove(id);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+} // namespace
+
+BENCHMARK(spatial_index_commit)->Unit(benchmark::kMillisecond);
+BENCHMARK(spatial_index_query<0>)->Name("spatial_index_point");
+BENCHMARK(spatial_index_query<1>)->Name("spatial_index_radius");
+BENCHMARK(spatial_index_query<2>)->Name("spatial_index_rect");
+BENCHMARK(spatial_index_frame);
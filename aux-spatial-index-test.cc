@@ -0,0 +1,99 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/spatial-index.hpp>
+
+#include <random>
+#include <optional>
+#include <vector>
+#include <algorithm>
+
+class aux_spatial_index_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+namespace
+{
+    using aux::bounding_box;
+    using point = aux::versor<float, 2>;
+
+    bounding_box random_box(std::mt19937& gen) {
+        std::uniform_real_distribution<float> pos{-500.0f, 1500.0f}, size{0.0f, 40.0f}, big{0.0f, 400.0f};
+        point lo{pos(gen), pos(gen)};
+        auto s = gen() % 16 == 0 ? big : size;
+        return {lo, lo + point{s(gen), s(gen)}};
+    }
+
+    // Brute force over the live boxes against the index, all query kinds.
+    void check(aux::spatial_index const& index, std::vector<std::optional<bounding_box>> const& boxes, std::mt19937& gen) {
+        std::uniform_real_distribution<float> pos{-600.0f, 1600.0f}, radius{0.0f, 60.0f};
+        for (int q = 0; q < 50; ++q) {
+            auto range = random_box(gen);
+            point p{pos(gen), pos(gen)};
+            auto r = radius(gen);
+            std::vector<uint32_t> expected[3], actual[3];
+            for (uint32_t id = 0; id < boxes.size(); ++id) {
+                if (!boxes[id]) continue;
+                if (boxes[id]->overlaps(range)) expected[0].push_back(id);
+                if (boxes[id]->distance2(p) <= r * r) expected[1].push_back(id);
+                if (boxes[id]->overlaps({p, p})) expected[2].push_back(id);
+            }
+            index.query(range, [&](uint32_t id) { actual[0].push_back(id); });
+            index.query(p, r, [&](uint32_t id) { actual[1].push_back(id); });
+            index.query(p, [&](uint32_t id) { actual[2].push_back(id); });
+            for (int k = 0; k < 3; ++k) {
+                std::sort(actual[k].begin(), actual[k].end());
+                ASSERT_EQ(actual[k], expected[k]) << k;
+            }
+        }
+    }
+} // namespace
+
+TEST_F(aux_spatial_index_test, box) {
+    bounding_box b{{0, 0}, {10, 5}};
+    ASSERT_TRUE(b.overlaps({{10, 5}, {11, 6}}));
+    ASSERT_FALSE(b.overlaps({{10.5f, 0}, {11, 6}}));
+    ASSERT_EQ(b.distance2({13, 9}), 25.0f);
+    ASSERT_EQ(b.distance2({3, 3}), 0.0f);
+}
+
+TEST_F(aux_spatial_index_test, grid_and_tree) {
+    std::mt19937 gen{5};
+    aux::spatial_index index{32.0f};
+    std::vector<std::optional<bounding_box>> boxes(3000);
+    for (uint32_t id = 0; id < 2000; ++id) {
+        boxes[id] = random_box(gen);
+        index.insert(id, *boxes[id]);
+    }
+    ASSERT_EQ(index.hot(), 2000u);
+    check(index, boxes, gen);
+
+    index.commit();
+    ASSERT_EQ(index.hot(), 0u);
+    ASSERT_EQ(index.committed(), 2000u);
+    check(index, boxes, gen);
+
+    // per frame churn on top of the tree: new ids, moved and removed ones
+    for (int frame = 0; frame < 20; ++frame) {
+        for (int k = 0; k < 50; ++k) {
+            auto id = static_cast<uint32_t>(gen() % boxes.size());
+            if (gen() % 3 == 0) {
+                boxes[id].reset();
+                index.remove(id);
+            }
+            else {
+                boxes[id] = random_box(gen);
+                index.insert(id, *boxes[id]);
+            }
+        }
+        ASSERT_EQ(index.size(), static_cast<size_t>(std::count_if(boxes.begin(), boxes.end(), [](auto const& b) { return b.has_value(); })));
+        check(index, boxes, gen);
+        if (frame % 7 == 6) index.commit();
+    }
+
+    index.clear();
+    ASSERT_EQ(index.size(), 0u);
+    index.query(bounding_box{{-1e6f, -1e6f}, {1e6f, 1e6f}}, [](uint32_t) { FAIL(); });
+}
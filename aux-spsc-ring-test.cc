@@ -0,0 +1,73 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/spsc-ring.hpp>
+
+#include <array>
+#include <thread>
+
+class aux_spsc_ring_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+TEST_F(aux_spsc_ring_test, push_drain) {
+    aux::spsc_ring<int, 8> ring;
+    std::array<int, 16> out{};
+    ASSERT_TRUE(ring.empty());
+    ASSERT_EQ(ring.drain(out), 0);
+
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 6; ++i) {
+            ASSERT_TRUE(ring.try_push(round * 10 + i));
+        }
+        ASSERT_EQ(ring.size(), 6);
+        ASSERT_EQ(ring.drain(std::span{out}.first(4)), 4);
+        ASSERT_EQ(out[0], round * 10);
+        ASSERT_EQ(out[3], round * 10 + 3);
+        ASSERT_EQ(ring.drain(out), 2);
+        ASSERT_EQ(out[1], round * 10 + 5);
+    }
+    ASSERT_EQ(ring.pushed(), 30);
+    ASSERT_EQ(ring.dropped(), 0);
+    ASSERT_EQ(ring.high_water(), 6);
+}
+
+TEST_F(aux_spsc_ring_test, overflow) {
+    aux::spsc_ring<int, 4> ring;
+    for (int i = 0; i < 6; ++i) {
+        ring.try_push(i);
+    }
+    ASSERT_EQ(ring.pushed(), 4);
+    ASSERT_EQ(ring.dropped(), 2);
+    ASSERT_EQ(ring.high_water(), 4);
+
+    std::array<int, 8> out{};
+    ASSERT_EQ(ring.drain(out), 4);
+    ASSERT_EQ(out[0], 0);
+    ASSERT_EQ(out[3], 3);
+}
+
+TEST_F(aux_spsc_ring_test, threads) {
+    constexpr int count = 1'000'000;
+    aux::spsc_ring<int, 1024> ring;
+    std::thread producer{[&ring] {
+        for (int i = 0; i < count; ) {
+            if (ring.try_push(i)) ++i;
+            else std::this_thread::yield();
+        }
+    }};
+    std::array<int, 64> batch;
+    int expected = 0;
+    while (expected < count) {
+        auto n = ring.drain(batch);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(batch[i], expected++);
+        }
+    }
+    producer.join();
+    ASSERT_EQ(ring.pushed(), count);
+    ASSERT_LE(ring.high_water(), 1024);
+}
@@ -0,0 +1,50 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/thread-pool.hpp>
+
+#include <atomic>
+#include <vector>
+#include <numeric>
+
+class aux_thread_pool_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+TEST_F(aux_thread_pool_test, parallel_for) {
+    for (size_t threads : {1, 2, 4, 8}) {
+        aux::thread_pool pool{threads};
+        ASSERT_EQ(pool.concurrency(), threads);
+        for (size_t grain : {1, 3, 64, 1000}) {
+            std::vector<int> hits(1000, 0);
+            pool.parallel_for(hits.size(), [&](size_t i) { hits[i] += 1; }, grain);
+            ASSERT_TRUE(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+        }
+        pool.parallel_for(0, [](size_t) { FAIL(); });
+    }
+}
+
+TEST_F(aux_thread_pool_test, nested) {
+    aux::thread_pool pool{4};
+    std::atomic<size_t> sum = 0;
+    pool.parallel_for(16, [&](size_t i) {
+        pool.parallel_for(100, [&, i](size_t k) {
+            sum.fetch_add(i * 100 + k, std::memory_order_relaxed);
+        });
+    });
+    ASSERT_EQ(sum.load(), 1599 * 1600 / 2);
+}
+
+TEST_F(aux_thread_pool_test, repeated) {
+    aux::thread_pool pool{3};
+    std::vector<uint64_t> data(4096);
+    std::iota(data.begin(), data.end(), 0);
+    for (int round = 0; round < 200; ++round) {
+        pool.parallel_for(data.size(), [&](size_t i) { data[i] += 1; }, 32);
+    }
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(data[i], i + 200);
+    }
+}
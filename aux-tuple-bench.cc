@@ -0,0 +1,120 @@
+
+#include <benchmark/benchmark.h>
+
+#include <aux/packed-column.hpp>
+#include <aux/versor.hpp>
+
+#include <array>
+#include <cstring>
+#include <spanstream>
+#include <vector>
+
+namespace
+{
+    constexpr size_t records = 1 << 16;
+    using record = aux::packed_tuple<double, char, int>;
+
+    auto make_records() {
+        std::vector<record> ret;
+        ret.reserve(records);
+        for (size_t i = 0; i < records; ++i) {
+            ret.emplace_back(i * 0.5, 'p', static_cast<int>(i));
+        }
+        return ret;
+    }
+
+    // the same field read from naturally aligned storage, for reference
+    void tuple_get_aligned(benchmark::State& state) {
+        std::vector<std::tuple<double, char, int>> src(records);
+        for (size_t i = 0; i < records; ++i) {
+            src[i] = {i * 0.5, 'p', static_cast<int>(i)};
+        }
+        for (auto _ : state) {
+            long sum = 0;
+            for (auto const& r : src) sum += get<2>(r);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * records);
+    }
+
+    void packed_tuple_get(benchmark::State& state) {
+        auto src = make_records();
+        for (auto _ : state) {
+            long sum = 0;
+            for (auto const& r : src) sum += get<2>(r);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * records);
+    }
+
+    void packed_tuple_get_unaligned(benchmark::State& state) {
+        auto src = make_records();
+        std::vector<std::byte> wire(1 + src.size() * sizeof (record));
+        std::memcpy(wire.data() + 1, src.data(), wire.size() - 1);
+        std::span<record const> view{reinterpret_cast<record const*>(wire.data() + 1), src.size()};
+        for (auto _ : state) {
+            long sum = 0;
+            for (auto const& r : view) sum += get<2>(r);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * records);
+    }
+
+    void packed_tuple_gather(benchmark::State& state) {
+        auto src = make_records();
+        std::vector<int> column(records);
+        for (auto _ : state) {
+            aux::gather<2>(std::span{src}, std::span{column});
+            benchmark::DoNotOptimize(column.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * records);
+        state.SetBytesProcessed(state.iterations() * records * sizeof (record));
+    }
+
+    template <class T>
+    void format_stream(benchmark::State& state, T const& t) {
+        std::array<char, 128> buf;
+        for (auto _ : state) {
+            std::spanstream output{buf};
+            output << t;
+            benchmark::DoNotOptimize(buf.data());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <class T>
+    void format_to_chars(benchmark::State& state, T const& t) {
+        std::array<char, 128> buf;
+        for (auto _ : state) {
+            auto ret = aux::to_chars(buf.data(), buf.data() + buf.size(), t);
+            benchmark::DoNotOptimize(ret.ptr);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <class T>
+    void parse_from_chars(benchmark::State& state, T t) {
+        std::array<char, 128> buf;
+        auto end = aux::to_chars(buf.data(), buf.data() + buf.size(), t).ptr;
+        for (auto _ : state) {
+            auto ret = aux::from_chars(buf.data(), end, t);
+            benchmark::DoNotOptimize(ret.ptr);
+            benchmark::DoNotOptimize(t);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    constexpr record sample_record{3.14, 'c', 42};
+    constexpr aux::versor<double, 4> sample_versor{0.125, -2.5, 1e10, 3.0};
+}
+
+BENCHMARK(tuple_get_aligned);
+BENCHMARK(packed_tuple_get);
+BENCHMARK(packed_tuple_get_unaligned);
+BENCHMARK(packed_tuple_gather);
+BENCHMARK_CAPTURE(format_stream, packed_tuple, sample_record);
+BENCHMARK_CAPTURE(format_to_chars, packed_tuple, sample_record);
+BENCHMARK_CAPTURE(format_stream, versor, sample_versor);
+BENCHMARK_CAPTURE(format_to_chars, versor, sample_versor);
+BENCHMARK_CAPTURE(parse_from_chars, versor, sample_versor);
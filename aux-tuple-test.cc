@@ -3,6 +3,9 @@
 #include <aux/packed-tuple.hpp>
 
 #include <spanstream>
+#include <string>
+#include <string_view>
+#include <iterator>
 
 
 class aux_tuple_test : public testing::Test {
@@ -94,3 +97,59 @@ TEST_F(aux_tuple_test, structual_binding) {
         ASSERT_TRUE(c == 42);
     }
 }
+
+TEST_F(aux_tuple_test, chars_format) {
+    {
+        constexpr std::tuple t{1, 2.5, 'x', true};
+        std::array<char, 32> buf{};
+        auto [ptr, ec] = aux::to_chars(buf.data(), buf.data() + buf.size(), t);
+        ASSERT_TRUE(ec == std::errc());
+        ASSERT_EQ(std::string_view(buf.data(), ptr), "(1 2.5 x 1)");
+
+        std::tuple<int, double, char, bool> u;
+        auto parsed = aux::from_chars(buf.data(), ptr, u);
+        ASSERT_TRUE(parsed.ec == std::errc());
+        ASSERT_EQ(parsed.ptr, ptr);
+        ASSERT_TRUE(u == t);
+    }
+    {
+        constexpr aux::packed_tuple t{3.14, 'c', 42};
+        std::array<char, 32> buf{};
+        auto [ptr, ec] = aux::to_chars(buf.data(), buf.data() + buf.size(), t);
+        ASSERT_TRUE(ec == std::errc());
+        ASSERT_EQ(std::string_view(buf.data(), ptr), "(3.14 c 42)");
+
+        std::string out;
+        aux::write_to(std::back_inserter(out), t);
+        ASSERT_EQ(out, "(3.14 c 42)");
+    }
+    {
+        constexpr std::tuple t{std::tuple{1, 2}, -3};
+        std::array<char, 32> buf{};
+        auto [ptr, ec] = aux::to_chars(buf.data(), buf.data() + buf.size(), t);
+        ASSERT_TRUE(ec == std::errc());
+        ASSERT_EQ(std::string_view(buf.data(), ptr), "((1 2) -3)");
+    }
+    {
+        // too small a buffer and malformed input are reported, not overrun
+        constexpr std::tuple t{12345, 67890};
+        std::array<char, 8> buf{};
+        auto [ptr, ec] = aux::to_chars(buf.data(), buf.data() + buf.size(), t);
+        ASSERT_TRUE(ec == std::errc::value_too_large);
+
+        std::tuple<int, int> u;
+        std::string_view bad = "(1 x)";
+        auto parsed = aux::from_chars(bad.data(), bad.data() + bad.size(), u);
+        ASSERT_TRUE(parsed.ec == std::errc::invalid_argument);
+        ASSERT_EQ(parsed.ptr, bad.data() + 3);
+        std::string_view open = "(1  2";
+        parsed = aux::from_chars(open.data(), open.data() + open.size(), u);
+        ASSERT_TRUE(parsed.ec == std::errc::invalid_argument);
+    }
+#if defined(__cpp_lib_format)
+    {
+        constexpr aux::packed_tuple t{3.14, 'c', 42};
+        ASSERT_EQ(std::format("{}", t), "(3.14 c 42)");
+    }
+#endif
+}
@@ -0,0 +1,140 @@
+
+#include <benchmark/benchmark.h>
+
+#include <aux/versor.hpp>
+#include <aux/versor-soa.hpp>
+#include <aux/flat-versor.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr size_t points = 1 << 14;
+
+    template <class T, size_t N>
+    auto random_versors(size_t n) {
+        std::mt19937 gen{42};
+        std::vector<aux::versor<T, N>> ret(n);
+        for (auto& v : ret) {
+            for (auto& x : v) {
+                x = static_cast<T>(std::uniform_int_distribution<int>(1, 100)(gen));
+            }
+        }
+        return ret;
+    }
+
+    template <class Op, class T, size_t N>
+    void versor_binary(benchmark::State& state) {
+        auto a = random_versors<T, N>(points);
+        auto b = random_versors<T, N>(points);
+        std::vector<aux::versor<T, N>> c(points);
+        for (auto _ : state) {
+            for (size_t i = 0; i < points; ++i) {
+                c[i] = Op()(a[i], b[i]);
+            }
+            benchmark::DoNotOptimize(c.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * points);
+        state.SetBytesProcessed(state.iterations() * points * sizeof (aux::versor<T, N>) * 3);
+    }
+
+    struct sum { auto operator()(auto const& a, auto const& b) const noexcept { return a + b; } };
+    struct product { auto operator()(auto const& a, auto const& b) const noexcept { return a * b; } };
+    struct quotient { auto operator()(auto const& a, auto const& b) const noexcept { return a / b; } };
+    struct exclusive_or { auto operator()(auto const& a, auto const& b) const noexcept { return a ^ b; } };
+    struct scaled { auto operator()(auto const& a, auto const& b) const noexcept { return a * b.front(); } };
+    struct chain { auto operator()(auto const& a, auto const& b) const noexcept { return a + b * b.front() - a; } };
+    struct lazy_chain {
+        auto operator()(auto const& a, auto const& b) const noexcept {
+            return std::remove_cvref_t<decltype (a)>(aux::lazy(a) + aux::lazy(b) * b.front() - a);
+        }
+    };
+
+    template <class T, size_t N>
+    void versor_inner(benchmark::State& state) {
+        auto a = random_versors<T, N>(points);
+        auto b = random_versors<T, N>(points);
+        std::vector<T> out(points);
+        for (auto _ : state) {
+            aux::inner(std::span{a}, b, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * points);
+    }
+
+    template <class T, size_t N>
+    void versor_distance(benchmark::State& state) {
+        auto a = random_versors<T, N>(points);
+        auto b = random_versors<T, N>(points);
+        std::vector<T> out(points);
+        for (auto _ : state) {
+            aux::distance(std::span{a}, b, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * points);
+    }
+
+    template <class T, size_t N>
+    void versor_soa_axpy(benchmark::State& state) {
+        auto aos = random_versors<T, N>(points);
+        aux::versor_soa<T, N> a{std::span<aux::versor<T, N> const>{aos}};
+        aux::versor_soa<T, N> b = a;
+        for (auto _ : state) {
+            a *= T(1);
+            a += b;
+            benchmark::DoNotOptimize(a.column(0).data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * points);
+        state.SetBytesProcessed(state.iterations() * points * sizeof (T) * N * 3);
+    }
+
+    template <class T, size_t N>
+    void flat_versor_add(benchmark::State& state) {
+        auto aos = random_versors<T, N>(points);
+        std::vector<aux::flat_versor<T, N>> a(aos.begin(), aos.end());
+        std::vector<aux::flat_versor<T, N>> c(points);
+        for (auto _ : state) {
+            for (size_t i = 0; i < points; ++i) {
+                c[i] = a[i] + a[i];
+            }
+            benchmark::DoNotOptimize(c.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * points);
+    }
+}
+
+BENCHMARK(versor_binary<sum, float, 2>);
+BENCHMARK(versor_binary<sum, float, 4>);
+BENCHMARK(versor_binary<sum, float, 8>);
+BENCHMARK(versor_binary<sum, double, 3>);
+BENCHMARK(versor_binary<sum, double, 4>);
+BENCHMARK(versor_binary<sum, uint8_t, 4>);
+BENCHMARK(versor_binary<product, float, 4>);
+BENCHMARK(versor_binary<product, double, 4>);
+BENCHMARK(versor_binary<product, uint8_t, 4>);
+BENCHMARK(versor_binary<quotient, float, 4>);
+BENCHMARK(versor_binary<quotient, double, 4>);
+BENCHMARK(versor_binary<exclusive_or, uint8_t, 4>);
+BENCHMARK(versor_binary<exclusive_or, int32_t, 8>);
+BENCHMARK(versor_binary<scaled, float, 4>);
+BENCHMARK(versor_binary<scaled, double, 3>);
+BENCHMARK(versor_binary<chain, float, 8>);
+BENCHMARK(versor_binary<lazy_chain, float, 8>);
+BENCHMARK(versor_binary<chain, double, 16>);
+BENCHMARK(versor_binary<lazy_chain, double, 16>);
+BENCHMARK(versor_inner<float, 2>);
+BENCHMARK(versor_inner<float, 4>);
+BENCHMARK(versor_inner<double, 4>);
+BENCHMARK(versor_distance<float, 2>);
+BENCHMARK(versor_distance<float, 4>);
+BENCHMARK(versor_soa_axpy<float, 4>);
+BENCHMARK(versor_soa_axpy<double, 2>);
+BENCHMARK(flat_versor_add<float, 4>);
+BENCHMARK(flat_versor_add<double, 3>);
@@ -0,0 +1,112 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/versor.hpp>
+
+#include <cstring>
+#include <random>
+
+class aux_versor_simd_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+
+    template <class T, size_t N>
+    static auto random_versor(std::mt19937& gen, bool nonzero = false) {
+        aux::versor<T, N> v;
+        for (auto& x : v) {
+            if constexpr (std::is_floating_point_v<T>) {
+                x = std::uniform_real_distribution<T>(-1000, 1000)(gen);
+            }
+            else {
+                x = static_cast<T>(std::uniform_int_distribution<int>(0, 255)(gen));
+            }
+            if (nonzero && x == T()) {
+                x = T(1);
+            }
+        }
+        return v;
+    }
+
+    template <class T, size_t N>
+    static bool bit_equal(aux::versor<T, N> const& lhs, aux::versor<T, N> const& rhs) {
+        return std::memcmp(lhs.begin(), rhs.begin(), N * sizeof (T)) == 0;
+    }
+
+    // Lambdas are not lane-wise, so apply() with them always takes the
+    // scalar recursion and serves as the reference result.
+    template <class T, size_t N>
+    static void check_against_scalar() {
+        std::mt19937 gen{20240601};
+        for (int n = 0; n < 1000; ++n) {
+            auto a = random_versor<T, N>(gen);
+            auto b = random_versor<T, N>(gen, true);
+            auto s = b.front();
+            auto scalar = [](auto f) { return [f](T x, T y) noexcept -> T { return f(x, y); }; };
+
+            ASSERT_TRUE(bit_equal(a + b, (+a).apply(scalar(std::plus<T>()), b)));
+            ASSERT_TRUE(bit_equal(a - b, (+a).apply(scalar(std::minus<T>()), b)));
+            ASSERT_TRUE(bit_equal(a * b, (+a).apply(scalar(std::multiplies<T>()), b)));
+            ASSERT_TRUE(bit_equal(a / b, (+a).apply(scalar(std::divides<T>()), b)));
+            ASSERT_TRUE(bit_equal(-a, (+a).apply([](T x) noexcept -> T { return -x; })));
+            ASSERT_TRUE(bit_equal(a * s, (+a).apply([s](T x) noexcept -> T { return x * s; })));
+            if constexpr (std::is_integral_v<T>) {
+                ASSERT_TRUE(bit_equal(a ^ b, (+a).apply(scalar(std::bit_xor<T>()), b)));
+                ASSERT_TRUE(bit_equal(a | b, (+a).apply(scalar(std::bit_or<T>()), b)));
+                ASSERT_TRUE(bit_equal(a & b, (+a).apply(scalar(std::bit_and<T>()), b)));
+                ASSERT_TRUE(bit_equal(~a, (+a).apply([](T x) noexcept -> T { return ~x; })));
+            }
+        }
+    }
+};
+
+TEST_F(aux_versor_simd_test, native_shapes) {
+#if !defined(AUX_VERSOR_SCALAR)
+    static_assert(aux::simd::native_v<float, 4>);
+    static_assert(aux::simd::native_v<double, 4>);
+    static_assert(aux::simd::native_v<uint8_t, 4>);
+    static_assert(aux::simd::native_v<float, 8>);
+#endif
+    static_assert(!aux::simd::native_v<double, 3>);
+    static_assert(!aux::simd::native_v<char, 5>);
+}
+
+TEST_F(aux_versor_simd_test, bit_exact_float4) { check_against_scalar<float, 4>(); }
+TEST_F(aux_versor_simd_test, bit_exact_double4) { check_against_scalar<double, 4>(); }
+TEST_F(aux_versor_simd_test, bit_exact_uint8x4) { check_against_scalar<uint8_t, 4>(); }
+TEST_F(aux_versor_simd_test, bit_exact_float8) { check_against_scalar<float, 8>(); }
+TEST_F(aux_versor_simd_test, bit_exact_int32x4) { check_against_scalar<int32_t, 4>(); }
+TEST_F(aux_versor_simd_test, bit_exact_uint8x16) { check_against_scalar<uint8_t, 16>(); }
+
+TEST_F(aux_versor_simd_test, constant_evaluation) {
+    {
+        constexpr aux::versor<float, 4> a{1.5f, -2.0f, 0.25f, 8.0f};
+        constexpr aux::versor<float, 4> b{0.5f, 4.0f, -1.0f, 2.0f};
+        constexpr auto sum = a + b;
+        constexpr auto quot = a / b;
+        constexpr auto scaled = a * 3.0f;
+        static_assert(sum == aux::versor<float, 4>{2.0f, 2.0f, -0.75f, 10.0f});
+        static_assert(quot == aux::versor<float, 4>{3.0f, -0.5f, -0.25f, 4.0f});
+        static_assert(scaled == aux::versor<float, 4>{4.5f, -6.0f, 0.75f, 24.0f});
+
+        auto x = a;
+        auto y = b;
+        ASSERT_TRUE(x + y == sum);
+        ASSERT_TRUE(x / y == quot);
+        ASSERT_TRUE(x * 3.0f == scaled);
+    }
+    {
+        constexpr aux::versor<uint8_t, 4> a{250, 1, 128, 0};
+        constexpr aux::versor<uint8_t, 4> b{10, 255, 128, 1};
+        constexpr auto sum = a + b;
+        constexpr auto diff = a - b;
+        static_assert(sum == aux::versor<uint8_t, 4>{4, 0, 0, 1});
+        static_assert(diff == aux::versor<uint8_t, 4>{240, 2, 0, 255});
+
+        auto x = a;
+        auto y = b;
+        ASSERT_TRUE(x + y == sum);
+        ASSERT_TRUE(x - y == diff);
+        ASSERT_TRUE(-x == (aux::versor<uint8_t, 4>{6, 255, 128, 0}));
+    }
+}
@@ -0,0 +1,123 @@
+
+#include <gtest/gtest.h>
+
+#include <aux/versor-soa.hpp>
+
+#include <array>
+#include <vector>
+#include <spanstream>
+
+class aux_versor_soa_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+TEST_F(aux_versor_soa_test, layout) {
+    {
+        aux::versor_soa<float, 4> soa(100);
+        ASSERT_EQ(soa.size(), 100);
+        for (size_t c = 0; c < soa.width(); ++c) {
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(soa.column(c).data()) % 64, 0);
+            ASSERT_EQ(soa.column(c).size(), 100);
+        }
+    }
+    {
+        std::vector<aux::versor<int, 3>> aos{{1, 2, 3}, {4, 5, 6}};
+        aux::versor_soa<int, 3> soa{std::span{aos}};
+        ASSERT_EQ(soa.column<0>()[1], 4);
+        ASSERT_EQ(soa.column<2>()[0], 3);
+
+        std::vector<aux::versor<int, 3>> out(2);
+        soa.copy_to(out);
+        ASSERT_TRUE(out == aos);
+    }
+}
+
+TEST_F(aux_versor_soa_test, proxy) {
+    {
+        aux::versor_soa<double, 3> soa(2);
+        soa[1] = aux::versor<double, 3>{1.5, 2.5, 3.5};
+        ASSERT_EQ(get<0>(soa[1]), 1.5);
+        ASSERT_EQ(soa[1][2], 3.5);
+        get<1>(soa[0]) = 7.0;
+        ASSERT_EQ(soa.column<1>()[0], 7.0);
+        ASSERT_TRUE(soa[1] == (aux::versor<double, 3>{1.5, 2.5, 3.5}));
+
+        aux::versor<double, 3> v = soa[0];
+        ASSERT_TRUE(v == (aux::versor<double, 3>{0.0, 7.0, 0.0}));
+
+        soa[0] = soa[1];
+        ASSERT_TRUE(soa[0] == soa[1]);
+
+        auto [x, y, z] = soa[1];
+        ASSERT_EQ(x, 1.5);
+        ASSERT_EQ(y, 2.5);
+        ASSERT_EQ(z, 3.5);
+    }
+    {
+        aux::versor_soa<char, 3> const soa(1, {'x', 'y', 'z'});
+        std::array<char, 32> buf{};
+        std::spanstream output{buf};
+        output << soa[0];
+        ASSERT_STREQ("(x y z)", output.span().data());
+        ASSERT_THROW(soa.at(1), std::range_error);
+    }
+}
+
+TEST_F(aux_versor_soa_test, column_arithmetic) {
+    {
+        std::vector<aux::versor<float, 2>> aos;
+        for (int i = 0; i < 1000; ++i) {
+            aos.push_back({float(i), float(-i)});
+        }
+        aux::versor_soa<float, 2> a{std::span{aos}};
+        auto b = a * 2.0f + aux::versor<float, 2>{1.0f, 0.5f};
+        auto c = b - a;
+        for (size_t i = 0; i < aos.size(); ++i) {
+            auto expected = aos[i] * 2.0f + aux::versor<float, 2>{1.0f, 0.5f};
+            ASSERT_TRUE(b[i] == expected);
+            ASSERT_TRUE(c[i] == expected - aos[i]);
+        }
+        ASSERT_TRUE((-a)[3] == -aos[3]);
+        ASSERT_TRUE((a / 2.0f)[10] == aos[10] / 2.0f);
+        // a scalar divisor is applied as its reciprocal, like versor's
+        auto d = a / 3.0f;
+        for (size_t i = 0; i < aos.size(); ++i) {
+            ASSERT_TRUE(d[i] == aos[i] / 3.0f) << i;
+        }
+    }
+    {
+        aux::versor_soa<uint16_t, 2> v1(3, {0x00ff, 0xff00});
+        aux::versor_soa<uint16_t, 2> v2(3, {0xff00, 0x00ff});
+        auto v3 = v1 | v2;
+        ASSERT_TRUE(v3[2] == (aux::versor<uint16_t, 2>{0xffff, 0xffff}));
+        ASSERT_TRUE(~v1 == v2);
+        ASSERT_TRUE((v1 / 3)[1] == (aux::versor<uint16_t, 2>{0x0055, 0x5500}));
+        ASSERT_TRUE((v2 ^ v3) == v1);
+    }
+    {
+        // touching a single component column leaves the others alone
+        aux::versor_soa<float, 3> stroke(16, {1.0f, 2.0f, 0.5f});
+        for (auto& pressure : stroke.column<2>()) {
+            pressure *= 2.0f;
+        }
+        ASSERT_TRUE(stroke[15] == (aux::versor<float, 3>{1.0f, 2.0f, 1.0f}));
+    }
+    {
+        // a shorter operand is refused, a longer one read up to size()
+        aux::versor_soa<float, 2> a(4, {1.0f, 2.0f});
+        aux::versor_soa<float, 2> shorter(3, {1.0f, 1.0f});
+        aux::versor_soa<float, 2> longer(5, {1.0f, 1.0f});
+        ASSERT_THROW(a += shorter, std::length_error);
+        ASSERT_TRUE(a[3] == (aux::versor<float, 2>{1.0f, 2.0f}));
+        a += longer;
+        ASSERT_EQ(a.size(), 4);
+        ASSERT_TRUE(a[3] == (aux::versor<float, 2>{2.0f, 3.0f}));
+
+        std::vector<aux::versor<float, 2>> out(6, {9.0f, 9.0f});
+        a.copy_to(out);
+        ASSERT_TRUE(out[3] == (aux::versor<float, 2>{2.0f, 3.0f}));
+        ASSERT_TRUE(out[4] == (aux::versor<float, 2>{9.0f, 9.0f}));
+    }
+}
@@ -4,7 +4,10 @@
 #include <aux/versor.hpp>
 
 #include <array>
+#include <ranges>
+#include <utility>
 #include <spanstream>
+#include <string_view>
 
 class aux_versor_test : public testing::Test {
 protected:
@@ -209,3 +212,119 @@ TEST_F(aux_versor_test, linear_algebra) {
         ASSERT_TRUE(get<3>(v/2.0) == 2.0);
     }
 }
+
+TEST_F(aux_versor_test, lazy_expression) {
+    {
+        constexpr aux::versor<double, 3> a{1.0, 2.0, 3.0};
+        constexpr aux::versor<double, 3> b{0.5, -1.0, 4.0};
+        constexpr aux::versor<double, 3> c{2.0, 2.0, 2.0};
+        constexpr aux::versor<double, 3> eager = a + b * 2.0 - c;
+        constexpr aux::versor<double, 3> fused = aux::lazy(a) + aux::lazy(b) * 2.0 - c;
+        static_assert(eager == fused);
+        static_assert(get<0>(fused) == 0.0);
+        static_assert(get<1>(fused) == -2.0);
+        static_assert(get<2>(fused) == 9.0);
+        static_assert(aux::versor<double, 3>(a * aux::lazy(c) / 2.0) == a);
+        static_assert(aux::versor<double, 3>(-aux::lazy(a)) == -a);
+        static_assert(aux::versor<double, 3>(2.0 * (aux::lazy(a) - b)) == (a - b) * 2.0);
+
+        aux::versor<double, 3> v = aux::lazy(a) + aux::lazy(b) * 2.0 - c;
+        ASSERT_TRUE(v == eager);
+        v = aux::lazy(v) * v + a;
+        ASSERT_TRUE(v == eager * eager + a);
+    }
+    {
+        constexpr aux::versor<uint8_t, 4> a{250, 1, 128, 0x0f};
+        constexpr aux::versor<uint8_t, 4> b{10, 255, 128, 0xf0};
+        static_assert(aux::versor<uint8_t, 4>(aux::lazy(a) + b) == a + b);
+        static_assert(aux::versor<uint8_t, 4>(aux::lazy(a) * b - a) == a * b - a);
+        static_assert(aux::versor<uint8_t, 4>(~(aux::lazy(a) ^ b) | a) == (~(a ^ b) | a));
+        static_assert(aux::versor<uint8_t, 4>(aux::lazy(a) & b) == (a & b));
+    }
+}
+
+TEST_F(aux_versor_test, reduction) {
+    {
+        constexpr aux::versor<double, 4> a{1, 2, 3, 4};
+        constexpr aux::versor<double, 4> b{-1, 0.5, 2, 0};
+        static_assert(inner(a, b) == 6.0);
+        static_assert(norm2(a) == 30.0);
+        static_assert(distance2(a, b) == 4 + 2.25 + 1 + 16);
+        static_assert(min(b) == -1);
+        static_assert(max(a) == 4);
+        static_assert(min(a, b) == aux::versor<double, 4>{-1, 0.5, 2, 0});
+        static_assert(max(a, b) == a);
+        static_assert(lerp(a, b, 0.5) == aux::versor<double, 4>{0, 1.25, 2.5, 2});
+        static_assert(fma(a, b, a) == a * b + a);
+
+        auto x = a;
+        auto y = b;
+        ASSERT_EQ(inner(x, y), 6.0);
+        ASSERT_EQ(norm(aux::versor<double, 2>{3, 4}), 5.0);
+        ASSERT_EQ(distance(aux::versor<float, 3>{1, 1, 1}, aux::versor<float, 3>{1, 4, 5}), 5.0f);
+        ASSERT_TRUE(lerp(x, y, 0.5) == lerp(a, b, 0.5));
+    }
+    {
+        // run-time vector reduction rounds like the constant-evaluated one
+        constexpr aux::versor<float, 8> a{1e8f, 1.0f, -1e8f, 0.5f, 3.25f, 1e-3f, 7.0f, -2.5f};
+        constexpr aux::versor<float, 8> b{1.0f, 1e-7f, 1.0f, 3.0f, 0.1f, 1e5f, -0.3f, 0.7f};
+        constexpr float expected = inner(a, b);
+        auto x = a;
+        auto y = b;
+        ASSERT_EQ(inner(x, y), expected);
+    }
+    {
+        std::array<aux::versor<float, 2>, 4> poly{{{0, 0}, {3, 4}, {3, 0}, {0, 0}}};
+        std::array<float, 3> out{};
+        aux::distance(std::span{poly}.first(3), std::span{poly}.subspan(1), out);
+        ASSERT_EQ(out[0], 5.0f);
+        ASSERT_EQ(out[1], 4.0f);
+        ASSERT_EQ(out[2], 3.0f);
+        ASSERT_EQ(aux::length(std::span{poly}), 12.0f);
+        ASSERT_EQ(aux::length(std::span<aux::versor<float, 2> const>{poly}), 12.0f);
+
+        aux::inner(std::span{poly}.first(3), std::span{poly}.subspan(1), out);
+        ASSERT_EQ(out[1], 9.0f);
+
+        // only min(a.size(), b.size(), out.size()) results are written
+        std::array<float, 3> norms{-1.0f, -1.0f, -1.0f};
+        aux::norm(std::span{poly}.subspan(1, 2), norms);
+        ASSERT_EQ(norms[0], 5.0f);
+        ASSERT_EQ(norms[1], 3.0f);
+        ASSERT_EQ(norms[2], -1.0f);
+        aux::inner(std::span{poly}, std::span{poly}.first(1), out);
+        ASSERT_EQ(out[0], 0.0f);
+        ASSERT_EQ(out[1], 9.0f);
+    }
+}
+
+TEST_F(aux_versor_test, chars_format) {
+    {
+        aux::versor<double, 3> v{0.1, -2.0, 1e300};
+        std::array<char, 64> buf{};
+        auto [ptr, ec] = aux::to_chars(buf.data(), buf.data() + buf.size(), v);
+        ASSERT_TRUE(ec == std::errc());
+        ASSERT_EQ(std::string_view(buf.data(), ptr), "(0.1 -2 1e+300)");
+
+        aux::versor<double, 3> u;
+        auto parsed = aux::from_chars(buf.data(), ptr, u);
+        ASSERT_TRUE(parsed.ec == std::errc());
+        ASSERT_TRUE(u == v);
+    }
+    {
+        aux::versor<char, 5> v{'a', 'b', 'c', 'd', 'e'};
+        std::array<char, 32> buf{};
+        auto [ptr, ec] = aux::to_chars(buf.data(), buf.data() + buf.size(), v);
+        ASSERT_TRUE(ec == std::errc());
+        ASSERT_EQ(std::string_view(buf.data(), ptr), "(a b c d e)");
+    }
+#if defined(__cpp_lib_format)
+    {
+        aux::versor<int, 3> v{1, -2, 3};
+        ASSERT_EQ(std::format("{}", v), "(1 -2 3)");
+        // tuple_like types aux does not own are left to the standard library
+        static_assert(!aux::enable_formatter<std::pair<int, int>>);
+        static_assert(!aux::enable_formatter<std::ranges::subrange<int*>>);
+    }
+#endif
+}
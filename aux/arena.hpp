@@ -0,0 +1,307 @@
+#ifndef INCLUDE_AUX_ARENA_HPP
+#define INCLUDE_AUX_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory_resource>
+#include <algorithm>
+
+namespace aux
+{
+    namespace detail
+    {
+        inline std::atomic<size_t> heap_allocation_count = 0;
+        inline std::atomic<bool> heap_counting = false;
+
+        // Header placed at the start of every block taken from upstream.
+        struct alignas (std::max_align_t) block_header {
+            block_header* next;
+            size_t size;   // whole block, header included
+        };
+    } // ::detail
+
+    // Global operator new calls since start, counted only in programs
+    // where one translation unit expands AUX_COUNT_HEAP_ALLOCATIONS();
+    // heap_counting() tells whether one does.
+    inline size_t heap_allocations() noexcept {
+        return detail::heap_allocation_count.load(std::memory_order_relaxed);
+    }
+    inline bool heap_counting() noexcept {
+        return detail::heap_counting.load(std::memory_order_relaxed);
+    }
+
+    // Bump allocator for data that lives until the end of a frame.
+    // Allocation moves a pointer through a chain of blocks, deallocation
+    // does nothing, and reset() rewinds to the first block.  Blocks are kept
+    // across resets, so once the chain covers the largest frame no further
+    // upstream allocation happens.  Not thread safe.
+    class frame_arena : public std::pmr::memory_resource {
+    public:
+        explicit frame_arena(size_t block_size = 1 << 20,
+                             std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : block_size{std::max(block_size, sizeof (detail::block_header) * 2)}
+            , upstream{upstream}
+        {
+        }
+        frame_arena(frame_arena const&) = delete;
+        frame_arena& operator=(frame_arena const&) = delete;
+
+        ~frame_arena() override {
+            release();
+        }
+
+    public:
+        // Forgets every allocation; memory handed out before is reused.
+        void reset() noexcept {
+            high_water_mark = std::max(high_water_mark, used_bytes);
+            used_bytes = 0;
+            current = head;
+            cursor = head ? data(head) : nullptr;
+        }
+
+        // Returns every block to upstream.
+        void release() noexcept {
+            while (head) {
+                auto next = head->next;
+                upstream->deallocate(head, head->size, alignof (detail::block_header));
+                head = next;
+            }
+            current = nullptr;
+            cursor = nullptr;
+            used_bytes = 0;
+            capacity_bytes = 0;
+        }
+
+        size_t used() const noexcept { return used_bytes; }              // since reset, padding included
+        size_t high_water() const noexcept { return std::max(high_water_mark, used_bytes); }
+        size_t capacity() const noexcept { return capacity_bytes; }      // held from upstream
+        size_t upstream_allocations() const noexcept { return blocks; }
+
+    private:
+        static std::byte* data(detail::block_header* b) noexcept {
+            return reinterpret_cast<std::byte*>(b + 1);
+        }
+        static std::byte* end(detail::block_header* b) noexcept {
+            return reinterpret_cast<std::byte*>(b) + b->size;
+        }
+        static std::byte* align_up(std::byte* p, size_t alignment) noexcept {
+            auto a = reinterpret_cast<uintptr_t>(p);
+            return p + ((alignment - a % alignment) % alignment);
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            bytes = std::max<size_t>(bytes, 1);
+            while (current) {
+                auto p = align_up(cursor, alignment);
+                if (p <= end(current) && bytes <= static_cast<size_t>(end(current) - p)) {
+                    used_bytes += static_cast<size_t>(p + bytes - cursor);
+                    cursor = p + bytes;
+                    return p;
+                }
+                if (!current->next) break;
+                // the rest of this block is skipped until the next reset
+                used_bytes += static_cast<size_t>(end(current) - cursor);
+                current = current->next;
+                cursor = data(current);
+            }
+            // append a block big enough for this request
+            auto size = std::max(block_size, sizeof (detail::block_header) + bytes + alignment);
+            auto b = static_cast<detail::block_header*>(upstream->allocate(size, alignof (detail::block_header)));
+            b->next = nullptr;
+            b->size = size;
+            ++blocks;
+            capacity_bytes += size;
+            if (current) {
+                used_bytes += static_cast<size_t>(end(current) - cursor);
+                current->next = b;
+            }
+            else {
+                head = b;
+            }
+            current = b;
+            cursor = data(b);
+            return do_allocate(bytes, alignment);
+        }
+        void do_deallocate(void*, size_t, size_t) override {
+        }
+        bool do_is_equal(std::pmr::memory_resource const& rhs) const noexcept override {
+            return this == &rhs;
+        }
+
+    private:
+        size_t block_size;
+        std::pmr::memory_resource* upstream;
+        detail::block_header* head = nullptr;
+        detail::block_header* current = nullptr;
+        std::byte* cursor = nullptr;
+        size_t used_bytes = 0;
+        size_t high_water_mark = 0;
+        size_t capacity_bytes = 0;
+        size_t blocks = 0;
+    };
+
+    // Free lists of power-of-two size classes from 16 bytes up to
+    // max_block, carved from slabs taken from upstream, for long-lived
+    // chunks (stroke pieces and the like) that come and go in a few sizes.
+    // A freed block goes back to its class and is handed out again before
+    // any new slab is taken; slabs are returned only on destruction.
+    // Larger or over-aligned requests go straight to upstream.  Not thread
+    // safe.
+    class size_class_pool : public std::pmr::memory_resource {
+    public:
+        constexpr static size_t min_block = 16;
+        constexpr static size_t max_block = 64 << 10;
+        constexpr static size_t classes = std::bit_width(max_block / min_block);
+
+    public:
+        explicit size_class_pool(size_t slab_size = 64 << 10,
+                                 std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : slab_size{slab_size}
+            , upstream{upstream}
+        {
+        }
+        size_class_pool(size_class_pool const&) = delete;
+        size_class_pool& operator=(size_class_pool const&) = delete;
+
+        ~size_class_pool() override {
+            while (slabs) {
+                auto next = slabs->next;
+                upstream->deallocate(slabs, slabs->size, alignof (detail::block_header));
+                slabs = next;
+            }
+        }
+
+    public:
+        size_t in_use() const noexcept { return live; }                  // blocks handed out
+        size_t upstream_allocations() const noexcept { return taken; }   // slabs and oversized blocks
+
+        // Size of the block serving a request of bytes, 0 beyond max_block.
+        constexpr static size_t block_size(size_t bytes) noexcept {
+            return bytes > max_block ? 0 : std::bit_ceil(std::max(bytes, min_block));
+        }
+
+    private:
+        struct free_block {
+            free_block* next;
+        };
+
+        static size_t class_of(size_t bytes) noexcept {
+            return static_cast<size_t>(std::countr_zero(block_size(bytes) / min_block));
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (bytes > max_block || alignment > alignof (detail::block_header)) {
+                ++taken;
+                ++live;
+                return upstream->allocate(bytes, alignment);
+            }
+            auto c = class_of(bytes);
+            if (!free[c]) refill(c);
+            auto b = free[c];
+            free[c] = b->next;
+            ++live;
+            return b;
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            --live;
+            if (bytes > max_block || alignment > alignof (detail::block_header)) {
+                upstream->deallocate(p, bytes, alignment);
+                return;
+            }
+            auto c = class_of(bytes);
+            free[c] = ::new (p) free_block{free[c]};
+        }
+        bool do_is_equal(std::pmr::memory_resource const& rhs) const noexcept override {
+            return this == &rhs;
+        }
+
+        // Threads a new slab of class c onto its free list.
+        void refill(size_t c) {
+            auto size = min_block << c;
+            auto count = std::max<size_t>(slab_size / size, 1);
+            auto bytes = sizeof (detail::block_header) + count * size;
+            auto slab = static_cast<detail::block_header*>(upstream->allocate(bytes, alignof (detail::block_header)));
+            slab->next = slabs;
+            slab->size = bytes;
+            slabs = slab;
+            ++taken;
+            auto first = reinterpret_cast<std::byte*>(slab + 1);
+            for (size_t i = count; i-- > 0; ) {
+                free[c] = ::new (first + i * size) free_block{free[c]};
+            }
+        }
+
+    private:
+        size_t slab_size;
+        std::pmr::memory_resource* upstream;
+        std::array<free_block*, classes> free{};
+        detail::block_header* slabs = nullptr;
+        size_t live = 0;
+        size_t taken = 0;
+    };
+} // ::aux
+
+// Replaces the global operator new and delete, the nothrow forms included,
+// with malloc-based versions that count into aux::heap_allocations().
+// Expand it at namespace scope in exactly one translation unit of a program.
+#define AUX_COUNT_HEAP_ALLOCATIONS()                                                           \
+    namespace aux::detail {                                                                    \
+        [[maybe_unused]] static bool const heap_counting_enabled = [] {                        \
+            heap_counting.store(true, std::memory_order_relaxed);                              \
+            return true;                                                                       \
+        }();                                                                                   \
+        static void* counted_alloc(std::size_t n) noexcept {                                   \
+            heap_allocation_count.fetch_add(1, std::memory_order_relaxed);                     \
+            return std::malloc(n ? n : 1);                                                     \
+        }                                                                                      \
+        static void* counted_alloc(std::size_t n, std::align_val_t a) noexcept {               \
+            heap_allocation_count.fetch_add(1, std::memory_order_relaxed);                     \
+            auto alignment = static_cast<std::size_t>(a);                                      \
+            auto size = (std::max<std::size_t>(n, 1) + alignment - 1) / alignment * alignment; \
+            return std::aligned_alloc(alignment, size);                                        \
+        }                                                                                      \
+    }                                                                                          \
+    void* operator new(std::size_t n) {                                                        \
+        if (auto p = aux::detail::counted_alloc(n)) return p;                                  \
+        throw std::bad_alloc{};                                                                \
+    }                                                                                          \
+    void* operator new[](std::size_t n) { return ::operator new(n); }                          \
+    void* operator new(std::size_t n, std::align_val_t a) {                                    \
+        if (auto p = aux::detail::counted_alloc(n, a)) return p;                               \
+        throw std::bad_alloc{};                                                                \
+    }                                                                                          \
+    void* operator new[](std::size_t n, std::align_val_t a) { return ::operator new(n, a); }   \
+    void* operator new(std::size_t n, std::nothrow_t const&) noexcept {                        \
+        return aux::detail::counted_alloc(n);                                                  \
+    }                                                                                          \
+    void* operator new[](std::size_t n, std::nothrow_t const&) noexcept {                      \
+        return aux::detail::counted_alloc(n);                                                  \
+    }                                                                                          \
+    void* operator new(std::size_t n, std::align_val_t a, std::nothrow_t const&) noexcept {    \
+        return aux::detail::counted_alloc(n, a);                                               \
+    }                                                                                          \
+    void* operator new[](std::size_t n, std::align_val_t a, std::nothrow_t const&) noexcept {  \
+        return aux::detail::counted_alloc(n, a);                                               \
+    }                                                                                          \
+    void operator delete(void* p) noexcept { std::free(p); }                                   \
+    void operator delete[](void* p) noexcept { std::free(p); }                                 \
+    void operator delete(void* p, std::size_t) noexcept { std::free(p); }                      \
+    void operator delete[](void* p, std::size_t) noexcept { std::free(p); }                    \
+    void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }                 \
+    void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }               \
+    void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }    \
+    void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }  \
+    void operator delete(void* p, std::nothrow_t const&) noexcept { std::free(p); }            \
+    void operator delete[](void* p, std::nothrow_t const&) noexcept { std::free(p); }          \
+    void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept {          \
+        std::free(p);                                                                          \
+    }                                                                                          \
+    void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept {        \
+        std::free(p);                                                                          \
+    }
+#endif // INCLUDE_AUX_ARENA_HPP
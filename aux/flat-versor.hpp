@@ -0,0 +1,228 @@
+#ifndef INCLUDE_AUX_FLAT_VERSOR_HPP
+#define INCLUDE_AUX_FLAT_VERSOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <concepts>
+
+#include <aux/versor.hpp>
+
+namespace aux
+{
+    // Flat sibling of versor<T, N>: one alignas(Align) array instead of the
+    // recursive base chain.  Trivially copyable, standard layout and exactly
+    // N * sizeof (T) bytes, so arrays of flat_versor can be memcpy'ed into
+    // mapped buffers as they are.
+    template <class T, size_t N, size_t Align = alignof (T)>
+    struct flat_versor {
+        static_assert(N > 0);
+        static_assert(Align >= alignof (T) && (Align & (Align - 1)) == 0);
+        static_assert((N * sizeof (T)) % Align == 0, "Align must divide N * sizeof (T)");
+
+    public:
+        using value_type = T;
+        using iterator = value_type*;
+        using const_iterator = value_type const*;
+        using reference = value_type&;
+        using const_reference = value_type const&;
+        using size_type = size_t;
+
+    public:
+        constexpr friend size_t size(flat_versor) noexcept { return N; }
+        constexpr size_t size() const noexcept { return N; }
+
+    public:
+        alignas (Align) value_type elements[N];
+
+    public:
+        constexpr flat_versor(flat_versor const&) = default;
+        constexpr flat_versor(flat_versor&&) = default;
+        constexpr flat_versor& operator=(flat_versor const&) = default;
+        constexpr flat_versor& operator=(flat_versor&&) = default;
+        constexpr auto operator<=>(flat_versor const& rhs) const noexcept = default;
+
+    public:
+        constexpr flat_versor(auto... args) noexcept
+            requires (sizeof... (args) <= N && (std::constructible_from<T, decltype (args)> && ...))
+            : elements{static_cast<T>(args)...}
+        {
+            static_assert(std::is_trivially_copyable_v<flat_versor>);
+            static_assert(std::is_standard_layout_v<flat_versor>);
+            static_assert(sizeof (flat_versor) == N * sizeof (T));
+        }
+        constexpr flat_versor(versor<T, N> const& v) noexcept
+            : flat_versor{v, std::make_index_sequence<N>()}
+        {
+        }
+        constexpr operator versor<T, N>() const noexcept {
+            return [this]<size_t... I>(std::index_sequence<I...>) noexcept {
+                return versor<T, N>{elements[I]...};
+            }(std::make_index_sequence<N>());
+        }
+
+    private:
+        template <size_t... I>
+        constexpr flat_versor(versor<T, N> const& v, std::index_sequence<I...>) noexcept
+            : elements{v.template get<I>()...}
+        {
+        }
+
+    public:
+        template <size_t I>
+        constexpr auto get() const noexcept {
+            static_assert(I < N);
+            return elements[I];
+        }
+        template <size_t I>
+        constexpr auto& get() noexcept {
+            static_assert(I < N);
+            return elements[I];
+        }
+        template <size_t I>
+        constexpr friend auto get(flat_versor const& v) noexcept { return v.get<I>(); }
+        template <size_t I>
+        constexpr friend auto& get(flat_versor& v) noexcept { return v.get<I>(); }
+
+    public:
+        constexpr auto begin() const noexcept { return elements + 0; }
+        constexpr auto begin() noexcept { return elements + 0; }
+        constexpr auto end() const noexcept { return elements + N; }
+        constexpr auto end() noexcept { return elements + N; }
+        constexpr auto data() const noexcept { return elements + 0; }
+        constexpr auto data() noexcept { return elements + 0; }
+
+        constexpr auto front() const noexcept { return elements[0]; }
+        constexpr auto& front() noexcept { return elements[0]; }
+        constexpr auto back() const noexcept { return elements[N-1]; }
+        constexpr auto& back() noexcept { return elements[N-1]; }
+
+        constexpr auto& operator[](size_t i) noexcept { return elements[i]; }
+        constexpr auto operator[](size_t i) const noexcept { return elements[i]; }
+
+        constexpr auto& at(size_t i) {
+            if (this->size() <= i)
+                throw std::range_error("flat_versor index");
+            return (*this)[i];
+        }
+        constexpr auto at(size_t i) const {
+            if (this->size() <= i)
+                throw std::range_error("flat_versor index");
+            return (*this)[i];
+        }
+
+    public:
+        template <class Func, class... Rest>
+        constexpr auto& apply(Func&& func, Rest&&... rest) noexcept {
+            if !consteval {
+                if constexpr (simd::native_v<T, N> && simd::lane_wise<Func, sizeof... (Rest) + 1> &&
+                              (std::same_as<std::remove_cvref_t<Rest>, flat_versor> && ...))
+                {
+                    simd::apply<T, N>(func, this->data(), rest.data()...);
+                    return *this;
+                }
+            }
+            for (size_t i = 0; i < N; ++i) {
+                elements[i] = func(elements[i], rest.elements[i]...);
+            }
+            return *this;
+        }
+
+        constexpr auto& negate() noexcept { return apply(std::negate<T>()); }
+        constexpr auto& lognot() noexcept { return apply(std::bit_not<T>()); }
+
+    public:
+        constexpr auto operator+() const noexcept { return *this; }
+        constexpr auto operator-() const noexcept { return (+(*this)).negate(); }
+
+        constexpr auto& operator+=(flat_versor const& rhs) noexcept { return apply(std::plus<T>(), rhs); }
+        constexpr auto& operator-=(flat_versor const& rhs) noexcept { return apply(std::minus<T>(), rhs); }
+        constexpr auto& operator*=(flat_versor const& rhs) noexcept { return apply(std::multiplies<T>(), rhs); }
+        constexpr auto& operator/=(flat_versor const& rhs) noexcept { return apply(std::divides<T>(), rhs); }
+
+        constexpr auto operator+(flat_versor const& rhs) const noexcept { return (+(*this)) += rhs; }
+        constexpr auto operator-(flat_versor const& rhs) const noexcept { return (+(*this)) -= rhs; }
+        constexpr auto operator*(flat_versor const& rhs) const noexcept { return (+(*this)) *= rhs; }
+        constexpr auto operator/(flat_versor const& rhs) const noexcept { return (+(*this)) /= rhs; }
+
+        constexpr auto& operator*=(value_type s) noexcept {
+            if !consteval {
+                if constexpr (simd::native_v<T, N>) {
+                    simd::scale<T, N>(this->data(), s);
+                    return *this;
+                }
+            }
+            for (auto& x : elements) x *= s;
+            return *this;
+        }
+        constexpr auto operator*(value_type s) const noexcept { return (+(*this)) *= s; }
+        constexpr friend auto operator*(value_type s, flat_versor v) noexcept { return v * s; }
+        constexpr auto& operator/=(value_type s) noexcept { return (*this) *= (1/s); }
+        constexpr auto operator/(value_type s) const noexcept { return (+(*this)) /= s; }
+
+        constexpr auto operator~() const noexcept { return (+(*this)).lognot(); }
+
+        constexpr auto& operator^=(flat_versor const& rhs) noexcept { return apply(std::bit_xor<T>(), rhs); }
+        constexpr auto& operator|=(flat_versor const& rhs) noexcept { return apply(std::bit_or<T>(), rhs); }
+        constexpr auto& operator&=(flat_versor const& rhs) noexcept { return apply(std::bit_and<T>(), rhs); }
+
+        constexpr auto operator^(flat_versor const& rhs) const noexcept { return (+(*this)) ^= rhs; }
+        constexpr auto operator|(flat_versor const& rhs) const noexcept { return (+(*this)) |= rhs; }
+        constexpr auto operator&(flat_versor const& rhs) const noexcept { return (+(*this)) &= rhs; }
+    };
+
+    template <class T, size_t N, size_t Align>
+    constexpr T inner(flat_versor<T, N, Align> const& a, flat_versor<T, N, Align> const& b) noexcept {
+        if !consteval {
+            if constexpr (simd::native_v<T, N>) {
+                return simd::inner<T, N>(a.data(), b.data());
+            }
+        }
+        return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            return simd::pairwise_sum(std::array<T, N>{static_cast<T>(a[I] * b[I])...});
+        }(std::make_index_sequence<N>());
+    }
+    template <class T, size_t N, size_t Align>
+    constexpr T norm2(flat_versor<T, N, Align> const& v) noexcept { return inner(v, v); }
+    template <class T, size_t N, size_t Align>
+    constexpr auto norm(flat_versor<T, N, Align> const& v) noexcept { return std::sqrt(norm2(v)); }
+    template <class T, size_t N, size_t Align>
+    constexpr auto distance(flat_versor<T, N, Align> const& a, flat_versor<T, N, Align> const& b) noexcept {
+        return norm(a - b);
+    }
+
+    static_assert(std::is_trivially_copyable_v<flat_versor<float, 4, 16>>);
+    static_assert(std::is_standard_layout_v<flat_versor<float, 4, 16>>);
+    static_assert(sizeof (flat_versor<float, 4, 16>) == 4 * sizeof (float));
+    static_assert(sizeof (flat_versor<uint8_t, 4, 4>) == 4 * sizeof (uint8_t));
+    static_assert(sizeof (flat_versor<double, 3>) == 3 * sizeof (double));
+
+    template <class T, size_t N, size_t Align>
+    constexpr bool enable_formatter<flat_versor<T, N, Align>> = true;
+} // ::aux
+
+namespace std
+{
+    template <class T, size_t N, size_t Align>
+    struct tuple_size<aux::flat_versor<T, N, Align>> {
+        static constexpr auto value = N;
+    };
+    template <class T, size_t N, size_t Align>
+    constexpr size_t tuple_size_v<aux::flat_versor<T, N, Align>> = N;
+
+    template <size_t I, class T, size_t N, size_t Align>
+    struct tuple_element<I, aux::flat_versor<T, N, Align>> {
+        using type = T;
+    };
+
+#if defined(__cpp_lib_format_ranges)
+    // formatted as tuple_like "(a b c)", not as a range "[a, b, c]"
+    template <class T, size_t N, size_t Align>
+    constexpr range_format format_kind<aux::flat_versor<T, N, Align>> = range_format::disabled;
+#endif
+} // namespace std
+
+#endif // INCLUDE_AUX_FLAT_VERSOR_HPP
@@ -0,0 +1,450 @@
+#ifndef INCLUDE_AUX_INTERSECTION_HPP
+#define INCLUDE_AUX_INTERSECTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <span>
+#include <set>
+#include <queue>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
+#include <aux/versor.hpp>
+#include <aux/thread-pool.hpp>
+
+namespace aux
+{
+    struct segment {
+        versor<double, 2> a;
+        versor<double, 2> b;
+    };
+
+    // A pair of intersecting segments, first < second, and a point they
+    // share: the crossing, the touching endpoint, or for collinear overlaps
+    // the leftmost point of the overlap.
+    struct intersection {
+        uint32_t first;
+        uint32_t second;
+        versor<double, 2> point;
+    };
+
+    namespace detail
+    {
+        inline void two_sum(double a, double b, double& x, double& y) noexcept {
+            x = a + b;
+            double bv = x - a;
+            double av = x - bv;
+            y = (a - av) + (b - bv);
+        }
+        inline void two_product(double a, double b, double& x, double& y) noexcept {
+            x = a * b;
+            y = std::fma(a, b, -x);
+        }
+
+        // Sign of sum(p[i] * q[i]) evaluated exactly: every product is split
+        // into two doubles and the lot summed into a nonoverlapping expansion
+        // whose most significant component carries the sign.
+        template <size_t N>
+        int exact_sign(double const (&p)[N], double const (&q)[N]) noexcept {
+            double e[2 * N + 1];
+            size_t m = 0;
+            auto grow = [&](double b) {
+                size_t k = 0;
+                for (size_t i = 0; i < m; ++i) {
+                    double h;
+                    two_sum(b, e[i], b, h);
+                    if (h != 0) e[k++] = h;
+                }
+                if (b != 0) e[k++] = b;
+                m = k;
+            };
+            for (size_t i = 0; i < N; ++i) {
+                double x, y;
+                two_product(p[i], q[i], x, y);
+                grow(y);
+                grow(x);
+            }
+            return m == 0 ? 0 : (e[m - 1] > 0) - (e[m - 1] < 0);
+        }
+
+        constexpr bool lexicographic_less(versor<double, 2> const& a, versor<double, 2> const& b) noexcept {
+            return get<0>(a) < get<0>(b) || (get<0>(a) == get<0>(b) && get<1>(a) < get<1>(b));
+        }
+    } // ::detail
+
+    // Orientation of c relative to the directed line a -> b: +1 left
+    // (counter-clockwise), -1 right, 0 collinear.  Exact for all finite
+    // inputs short of overflow and underflow; a floating point filter
+    // settles the common case and the exact sum runs only near zero.
+    inline int orientation(versor<double, 2> const& a, versor<double, 2> const& b, versor<double, 2> const& c) noexcept {
+        double ax = get<0>(a), ay = get<1>(a);
+        double bx = get<0>(b), by = get<1>(b);
+        double cx = get<0>(c), cy = get<1>(c);
+        double left = (ax - cx) * (by - cy);
+        double right = (ay - cy) * (bx - cx);
+        double det = left - right;
+        constexpr double eps = std::numeric_limits<double>::epsilon() / 2;
+        constexpr double bound = (3 + 16 * eps) * eps;
+        double limit = bound * (std::abs(left) + std::abs(right));
+        if (det > limit) return 1;
+        if (-det > limit) return -1;
+        double const p[] = {ax, -ax, -cx, -ay, ay, cy};
+        double const q[] = {by, cy, by, bx, cx, bx};
+        return detail::exact_sign(p, q);
+    }
+
+    // Whether p lies on the closed segment s.
+    inline bool on_segment(segment const& s, versor<double, 2> const& p) noexcept {
+        if (orientation(s.a, s.b, p) != 0) return false;
+        auto [lo, hi] = std::minmax(s.a, s.b, detail::lexicographic_less);
+        return !detail::lexicographic_less(p, lo) && !detail::lexicographic_less(hi, p);
+    }
+
+    enum class contact {
+        none,
+        touch,      // an endpoint lies on the other segment
+        cross,      // proper crossing of both interiors
+        overlap,    // collinear with a common stretch
+    };
+
+    // Exact classification of how two closed segments meet.
+    inline contact classify(segment const& s, segment const& t) noexcept {
+        auto o1 = orientation(s.a, s.b, t.a);
+        auto o2 = orientation(s.a, s.b, t.b);
+        auto o3 = orientation(t.a, t.b, s.a);
+        auto o4 = orientation(t.a, t.b, s.b);
+        if (o1 * o2 > 0 || o3 * o4 > 0) return contact::none;
+        if (o1 == 0 && o2 == 0 && o3 == 0 && o4 == 0) {
+            auto [slo, shi] = std::minmax(s.a, s.b, detail::lexicographic_less);
+            auto [tlo, thi] = std::minmax(t.a, t.b, detail::lexicographic_less);
+            if (detail::lexicographic_less(shi, tlo) || detail::lexicographic_less(thi, slo)) return contact::none;
+            bool point = s.a == s.b || t.a == t.b;
+            return point || shi == tlo || thi == slo ? contact::touch : contact::overlap;
+        }
+        return o1 && o2 && o3 && o4 ? contact::cross : contact::touch;
+    }
+
+    // The point reported for an intersecting pair.  Depends on the order of
+    // the arguments only through rounding; callers pass the lower index
+    // first so every pass reports the same bits for the same pair.
+    inline versor<double, 2> contact_point(segment const& s, segment const& t, contact c) noexcept {
+        switch (c) {
+        case contact::overlap:
+            return std::max(std::min(s.a, s.b, detail::lexicographic_less),
+                            std::min(t.a, t.b, detail::lexicographic_less), detail::lexicographic_less);
+        case contact::touch:
+            if (on_segment(s, t.a)) return t.a;
+            if (on_segment(s, t.b)) return t.b;
+            return on_segment(t, s.a) ? s.a : s.b;
+        default:
+            break;
+        }
+        auto r = s.b - s.a;
+        auto d = t.b - t.a;
+        auto w = t.a - s.a;
+        double u = (get<0>(w) * get<1>(d) - get<1>(w) * get<0>(d))
+                 / (get<0>(r) * get<1>(d) - get<1>(r) * get<0>(d));
+        versor<double, 2> p{get<0>(s.a) + u * get<0>(r), get<1>(s.a) + u * get<1>(r)};
+        // keep rounding inside both bounding boxes, so every strip of the
+        // parallel sweep that owns the point also holds both segments
+        auto lo = max(min(s.a, s.b), min(t.a, t.b));
+        auto hi = min(max(s.a, s.b), max(t.a, t.b));
+        return max(lo, min(hi, p));
+    }
+
+    // Reference O(n^2) all-pairs check.
+    inline std::vector<intersection> intersections_naive(std::span<segment const> segments) {
+        std::vector<intersection> ret;
+        for (uint32_t i = 0; i < segments.size(); ++i) {
+            for (uint32_t j = i + 1; j < segments.size(); ++j) {
+                auto c = classify(segments[i], segments[j]);
+                if (c != contact::none) {
+                    ret.push_back({i, j, contact_point(segments[i], segments[j], c)});
+                }
+            }
+        }
+        return ret;
+    }
+
+    // Bentley-Ottmann sweep, O((n + k) log n) for n segments and k
+    // intersecting pairs.  The sweep line moves left to right (bottom to
+    // top along a vertical line); the status tree orders the segments it
+    // crosses using exact orientation tests against event points.  Events
+    // at a shared endpoint are handled as one group, so any number of
+    // segments meeting there is reported pairwise and reordered exactly.
+    // Crossings away from endpoints are inexact points; they swap the two
+    // segments in place instead of re-inserting them, and a pair meeting
+    // at a point with others is swapped only while adjacent, so the order
+    // still follows from exact tests alone.  Every pair is reported once.
+    //
+    // The object keeps its buffers, so reusing one across calls does not
+    // allocate in steady state.
+    class sweep_line {
+    public:
+        sweep_line() = default;
+        sweep_line(sweep_line const&) = delete;
+        sweep_line& operator=(sweep_line const&) = delete;
+
+    public:
+        std::vector<intersection> const& operator()(std::span<segment const> segments) {
+            return run(segments, std::numeric_limits<double>::infinity(), std::nullopt);
+        }
+
+        // Finds the pairs whose reported point has x in [x0, x1), sweeping
+        // only until x1.  The parallel version below splits the plane into
+        // such strips.
+        std::vector<intersection> const& operator()(std::span<segment const> segments, double x0, double x1) {
+            return run(segments, x1, std::pair{x0, x1});
+        }
+
+    private:
+        struct node {
+            mutable uint32_t id;    // swapped in place at crossings
+        };
+        struct probe {
+            versor<double, 2> at;
+        };
+        struct compare {
+            using is_transparent = void;
+            sweep_line const* self;
+
+            // Whether s, which contains the event point, sorts above
+            // segment t of the status: by the side of t the event point
+            // lies on, then by where s heads, then by index.
+            bool above(uint32_t t, uint32_t s) const noexcept {
+                auto const& ts = self->normal[t];
+                if (auto o = orientation(ts.a, ts.b, self->at)) return o > 0;
+                if (auto o = orientation(ts.a, ts.b, self->normal[s].b)) return o > 0;
+                return s > t;
+            }
+            bool operator()(node const& x, node const& y) const noexcept {
+                if (x.id == y.id) return false;
+                return x.id == self->inserting ? !above(y.id, x.id) : above(x.id, y.id);
+            }
+            bool operator()(node const& x, probe const& p) const noexcept {
+                auto const& s = self->normal[x.id];
+                return orientation(s.a, s.b, p.at) > 0;
+            }
+            bool operator()(probe const& p, node const& x) const noexcept {
+                auto const& s = self->normal[x.id];
+                return orientation(s.a, s.b, p.at) < 0;
+            }
+        };
+        using status_type = std::set<node, compare>;
+
+        // Crossings sort before endpoint events at the same point; all the
+        // endpoint events at a point are taken as one group.
+        enum kind : uint32_t { crossing_event, start_event, end_event };
+        struct event {
+            versor<double, 2> at;
+            uint32_t kind;
+            uint32_t first;
+            uint32_t second;   // crossing_event only
+
+            friend bool operator<(event const& x, event const& y) noexcept {
+                if (x.at != y.at) return detail::lexicographic_less(x.at, y.at);
+                return x.kind < y.kind;
+            }
+            friend bool operator>(event const& x, event const& y) noexcept { return y < x; }
+        };
+
+        static uint64_t key(uint32_t a, uint32_t b) noexcept {
+            if (a > b) std::swap(a, b);
+            return static_cast<uint64_t>(a) << 32 | b;
+        }
+
+        std::vector<intersection> const& run(std::span<segment const> segments, double stop,
+                                             std::optional<std::pair<double, double>> strip)
+        {
+            found.clear();
+            reported.clear();
+            swapped.clear();
+            swaps = {};
+            status.clear();
+            input = segments;
+            window = strip;
+            normal.resize(segments.size());
+            where.resize(segments.size());
+            endpoints.clear();
+            for (uint32_t i = 0; i < segments.size(); ++i) {
+                auto [a, b] = std::minmax(segments[i].a, segments[i].b, detail::lexicographic_less);
+                normal[i] = {a, b};
+                if (strip && (get<0>(b) < strip->first || get<0>(a) >= strip->second)) continue;
+                endpoints.push_back({a, start_event, i, 0});
+                endpoints.push_back({b, end_event, i, 0});
+            }
+            std::sort(endpoints.begin(), endpoints.end(), [](event const& x, event const& y) {
+                return x < y;
+            });
+
+            size_t next = 0;
+            while (next < endpoints.size() || !swaps.empty()) {
+                bool crossing = !swaps.empty() && (next == endpoints.size() || !(endpoints[next] < swaps.top()));
+                auto const& head = crossing ? swaps.top() : endpoints[next];
+                if (get<0>(head.at) > stop) break;
+                if (crossing) {
+                    auto e = swaps.top();
+                    swaps.pop();
+                    cross(e.first, e.second);
+                }
+                else {
+                    at = endpoints[next].at;
+                    upper.clear();
+                    for (; next < endpoints.size() && endpoints[next].at == at; ++next) {
+                        if (endpoints[next].kind == start_event) upper.push_back(endpoints[next].first);
+                    }
+                    endpoint();
+                }
+            }
+            return found;
+        }
+
+        // All events at the endpoint `at`: U(p) starts here, the status
+        // segments through it end here (L) or pass through (C).
+        void endpoint() {
+            group.clear();
+            auto first = status.lower_bound(probe{at});
+            auto last = first;
+            for (; last != status.end(); ++last) {
+                auto const& s = normal[last->id];
+                if (orientation(s.a, s.b, at) != 0) break;
+                group.push_back(last->id);
+            }
+            auto passing = group.size();
+            group.insert(group.end(), upper.begin(), upper.end());
+            for (size_t i = 0; i < group.size(); ++i) {
+                for (size_t k = i + 1; k < group.size(); ++k) {
+                    check(group[i], group[k]);
+                    if (i < passing && k < passing) swapped.insert(key(group[i], group[k]));
+                }
+            }
+
+            auto below = first == status.begin() ? status.end() : std::prev(first);
+            status.erase(first, last);
+            for (size_t i = 0; i < passing; ++i) where[group[i]] = status.end();
+            size_t inserted = 0;
+            for (auto id : group) {
+                auto const& s = normal[id];
+                if (s.b == at) continue;   // ends here, degenerate segments included
+                inserting = id;
+                where[id] = status.insert(node{id}).first;
+                ++inserted;
+            }
+            inserting = no_segment;
+
+            if (inserted == 0) {
+                if (below != status.end() && std::next(below) != status.end()) {
+                    neighbours(below->id, std::next(below)->id);
+                }
+                return;
+            }
+            auto lo = status.lower_bound(probe{at});
+            auto hi = lo;
+            while (std::next(hi) != status.end()) {
+                auto const& s = normal[std::next(hi)->id];
+                if (orientation(s.a, s.b, at) != 0) break;
+                ++hi;
+            }
+            if (lo != status.begin()) neighbours(std::prev(lo)->id, lo->id);
+            if (std::next(hi) != status.end()) neighbours(hi->id, std::next(hi)->id);
+        }
+
+        void cross(uint32_t a, uint32_t b) {
+            if (swapped.contains(key(a, b))) return;
+            auto x = where[a];
+            auto y = where[b];
+            if (x == status.end() || y == status.end()) return;
+            if (std::next(x) != y) std::swap(x, y);
+            if (std::next(x) != y) return;   // rescheduled once they are adjacent
+            swapped.insert(key(a, b));
+            std::swap(x->id, y->id);
+            std::swap(where[a], where[b]);
+            if (x != status.begin()) neighbours(std::prev(x)->id, x->id);
+            if (std::next(y) != status.end()) neighbours(y->id, std::next(y)->id);
+        }
+
+        void neighbours(uint32_t a, uint32_t b) {
+            if (check(a, b) == contact::cross && !swapped.contains(key(a, b))) {
+                auto [i, k] = std::minmax(a, b);
+                swaps.push({contact_point(input[i], input[k], contact::cross), crossing_event, a, b});
+            }
+        }
+
+        // Reports the pair once if it meets, subject to the strip window.
+        contact check(uint32_t a, uint32_t b) {
+            auto [i, k] = std::minmax(a, b);
+            auto c = classify(normal[i], normal[k]);
+            if (c == contact::none || reported.contains(key(i, k))) return c;
+            auto p = contact_point(input[i], input[k], c);
+            if (!window || (get<0>(p) >= window->first && get<0>(p) < window->second)) {
+                found.push_back({i, k, p});
+            }
+            reported.insert(key(i, k));
+            return c;
+        }
+
+    private:
+        static constexpr uint32_t no_segment = std::numeric_limits<uint32_t>::max();
+
+        std::span<segment const> input;
+        std::optional<std::pair<double, double>> window;
+        std::vector<segment> normal;   // endpoints ordered left to right
+        std::vector<status_type::iterator> where;
+        std::vector<event> endpoints;
+        std::priority_queue<event, std::vector<event>, std::greater<>> swaps;
+        status_type status{compare{this}};
+        versor<double, 2> at;
+        uint32_t inserting = no_segment;
+        std::vector<uint32_t> upper;
+        std::vector<uint32_t> group;
+        std::unordered_set<uint64_t> reported;
+        std::unordered_set<uint64_t> swapped;
+        std::vector<intersection> found;
+    };
+
+    // Sequential sweep.
+    inline std::vector<intersection> intersections(std::span<segment const> segments) {
+        sweep_line sweep;
+        return sweep(segments);
+    }
+
+    // Parallel sweep: the plane is cut into vertical strips holding about
+    // the same number of segments and each strip is swept on its own,
+    // over the segments reaching into it, keeping the pairs whose point
+    // falls inside.  Every pair is reported by exactly one strip; the
+    // result is ordered by strip.
+    inline std::vector<intersection> intersections(std::span<segment const> segments, thread_pool& pool, size_t strips = 0) {
+        if (strips == 0) strips = pool.concurrency() * 4;
+        strips = std::clamp<size_t>(strips, 1, std::max<size_t>(segments.size() / 64, 1));
+        if (strips == 1) return intersections(segments);
+
+        std::vector<double> xs(segments.size());
+        for (size_t i = 0; i < segments.size(); ++i) {
+            xs[i] = std::min(get<0>(segments[i].a), get<0>(segments[i].b));
+        }
+        std::vector<double> cuts{-std::numeric_limits<double>::infinity()};
+        for (size_t i = 1; i < strips; ++i) {
+            auto nth = xs.begin() + static_cast<ptrdiff_t>(i * xs.size() / strips);
+            std::nth_element(xs.begin(), nth, xs.end());
+            if (*nth > cuts.back()) cuts.push_back(*nth);
+        }
+        cuts.push_back(std::numeric_limits<double>::infinity());
+
+        std::vector<std::vector<intersection>> parts(cuts.size() - 1);
+        pool.parallel_for(parts.size(), [&](size_t i) {
+            sweep_line sweep;
+            parts[i] = sweep(segments, cuts[i], cuts[i + 1]);
+        });
+        std::vector<intersection> ret;
+        for (auto& p : parts) ret.insert(ret.end(), p.begin(), p.end());
+        return ret;
+    }
+} // ::aux
+
+#endif // INCLUDE_AUX_INTERSECTION_HPP
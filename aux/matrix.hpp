@@ -0,0 +1,358 @@
+#ifndef INCLUDE_AUX_MATRIX_HPP
+#define INCLUDE_AUX_MATRIX_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <span>
+#include <utility>
+#include <algorithm>
+
+#include <aux/versor.hpp>
+#include <aux/versor-simd.hpp>
+#include <aux/thread-pool.hpp>
+
+namespace aux
+{
+    // R x C matrix stored as R versor rows.  Two shapes have a meaning
+    // beyond the plain linear map:
+    //
+    //   N x (N + 1)        affine map of N-space, p' = row . (p, 1), with
+    //                      an implicit last row (0 ... 0 1): matrix<T, 2, 3>
+    //                      pans, zooms and rotates the canvas
+    //   (N + 1) x (N + 1)  projective map of N-space (see project())
+    //
+    // A default matrix is the identity (ones on the diagonal).  Everything
+    // but rotation() and the span kernels is constexpr; products and maps
+    // of points are computed with the pairwise inner() of versor, so a
+    // constant, a run time and a span kernel result round alike.
+    template <class T, size_t R, size_t C>
+    struct matrix {
+        using value_type = T;
+        using row_type = versor<T, C>;
+        constexpr static size_t rows_size = R;
+        constexpr static size_t columns_size = C;
+
+    public:
+        constexpr matrix() noexcept
+            : rows{[]<size_t... I>(std::index_sequence<I...>) noexcept {
+                return std::array<row_type, R>{unit<I>()...};
+            }(std::make_index_sequence<R>())}
+        {
+        }
+        constexpr matrix(row_type const& r0, row_type const& r1) noexcept requires (R == 2)
+            : rows{r0, r1}
+        {
+        }
+        constexpr matrix(row_type const& r0, row_type const& r1, row_type const& r2) noexcept requires (R == 3)
+            : rows{r0, r1, r2}
+        {
+        }
+        constexpr matrix(row_type const& r0, row_type const& r1, row_type const& r2, row_type const& r3) noexcept
+            requires (R == 4)
+            : rows{r0, r1, r2, r3}
+        {
+        }
+
+        constexpr bool operator==(matrix const&) const noexcept = default;
+
+    public:
+        constexpr row_type const& operator[](size_t r) const noexcept { return rows[r]; }
+        constexpr row_type& operator[](size_t r) noexcept { return rows[r]; }
+
+        template <size_t J>
+        constexpr versor<T, R> column() const noexcept {
+            static_assert(J < C);
+            return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+                return versor<T, R>{get<J>(rows[I])...};
+            }(std::make_index_sequence<R>());
+        }
+
+    private:
+        template <size_t I>
+        constexpr static row_type unit() noexcept {
+            return [&]<size_t... J>(std::index_sequence<J...>) noexcept {
+                return row_type{static_cast<T>(I == J ? 1 : 0)...};
+            }(std::make_index_sequence<C>());
+        }
+
+    public:
+        std::array<row_type, R> rows;
+    };
+
+    template <class T> using matrix2x3 = matrix<T, 2, 3>;
+    template <class T> using matrix3x3 = matrix<T, 3, 3>;
+    template <class T> using matrix4x4 = matrix<T, 4, 4>;
+
+    template <class T, size_t R, size_t C>
+    constexpr matrix<T, C, R> transpose(matrix<T, R, C> const& m) noexcept {
+        matrix<T, C, R> ret;
+        [&]<size_t... J>(std::index_sequence<J...>) noexcept {
+            ((ret[J] = m.template column<J>()), ...);
+        }(std::make_index_sequence<C>());
+        return ret;
+    }
+
+    // Matrix product; (a * b) p = a (b p), b first.
+    template <class T, size_t R, size_t K, size_t C>
+    constexpr matrix<T, R, C> operator*(matrix<T, R, K> const& a, matrix<T, K, C> const& b) noexcept {
+        auto bt = transpose(b);
+        matrix<T, R, C> ret;
+        for (size_t r = 0; r < R; ++r) {
+            [&]<size_t... J>(std::index_sequence<J...>) noexcept {
+                ret[r] = versor<T, C>{inner(a[r], bt[J])...};
+            }(std::make_index_sequence<C>());
+        }
+        return ret;
+    }
+
+    // The (N + 1) x (N + 1) matrix of an affine map, implicit row included,
+    // and back.
+    template <class T, size_t N>
+    constexpr matrix<T, N + 1, N + 1> homogeneous(matrix<T, N, N + 1> const& m) noexcept {
+        matrix<T, N + 1, N + 1> ret;
+        for (size_t r = 0; r < N; ++r) ret[r] = m[r];
+        return ret;
+    }
+    template <class T, size_t N>
+    constexpr matrix<T, N - 1, N> affine(matrix<T, N, N> const& m) noexcept {
+        matrix<T, N - 1, N> ret;
+        for (size_t r = 0; r + 1 < N; ++r) ret[r] = m[r];
+        return ret;
+    }
+
+    // Composition of affine maps through their implicit last rows.
+    template <class T, size_t N>
+    constexpr matrix<T, N, N + 1> operator*(matrix<T, N, N + 1> const& a, matrix<T, N, N + 1> const& b) noexcept {
+        return affine(homogeneous(a) * homogeneous(b));
+    }
+
+    // Linear map of v.
+    template <class T, size_t N>
+    constexpr versor<T, N> operator*(matrix<T, N, N> const& m, versor<T, N> const& v) noexcept {
+        return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            return versor<T, N>{inner(m[I], v)...};
+        }(std::make_index_sequence<N>());
+    }
+
+    namespace detail
+    {
+        // (p[0], ..., p[N - 1], 1)
+        template <size_t N, class T, size_t M>
+        constexpr versor<T, N + 1> extend(versor<T, M> const& p) noexcept {
+            static_assert(N <= M);
+            return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+                return versor<T, N + 1>{get<I>(p)..., T{1}};
+            }(std::make_index_sequence<N>());
+        }
+    } // ::detail
+
+    // Affine map of the first N components of p; any further ones
+    // (pressure, tilt) pass through unchanged.
+    template <class T, size_t N, size_t M> requires (N <= M)
+    constexpr versor<T, M> operator*(matrix<T, N, N + 1> const& m, versor<T, M> const& p) noexcept {
+        auto h = detail::extend<N>(p);
+        auto ret = p;
+        [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            ((get<I>(ret) = inner(m[I], h)), ...);
+        }(std::make_index_sequence<N>());
+        return ret;
+    }
+
+    // Projective map of the first N components of p: (p, 1) is mapped
+    // linearly and divided by its last component.  Further components
+    // pass through.
+    template <class T, size_t N, size_t M> requires (0 < N && N - 1 <= M)
+    constexpr versor<T, M> project(matrix<T, N, N> const& m, versor<T, M> const& p) noexcept {
+        auto h = detail::extend<N - 1>(p);
+        auto w = inner(m[N - 1], h);
+        auto ret = p;
+        [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            ((get<I>(ret) = inner(m[I], h) / w), ...);
+        }(std::make_index_sequence<N - 1>());
+        return ret;
+    }
+
+    template <class T>
+    constexpr T determinant(matrix<T, 2, 2> const& m) noexcept {
+        return get<0>(m[0]) * get<1>(m[1]) - get<1>(m[0]) * get<0>(m[1]);
+    }
+    template <class T>
+    constexpr T determinant(matrix<T, 3, 3> const& m) noexcept {
+        auto [a, b, c] = std::array{get<0>(m[0]), get<1>(m[0]), get<2>(m[0])};
+        auto [d, e, f] = std::array{get<0>(m[1]), get<1>(m[1]), get<2>(m[1])};
+        auto [g, h, i] = std::array{get<0>(m[2]), get<1>(m[2]), get<2>(m[2])};
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    }
+    // of the linear part
+    template <class T>
+    constexpr T determinant(matrix<T, 2, 3> const& m) noexcept {
+        return get<0>(m[0]) * get<1>(m[1]) - get<1>(m[0]) * get<0>(m[1]);
+    }
+
+    // Inverse maps.  A singular matrix gives infinities or NaNs; check
+    // determinant() first where that can happen (a zoom of 0, say).
+    template <class T>
+    constexpr matrix<T, 2, 3> inverse(matrix<T, 2, 3> const& m) noexcept {
+        auto [a, b, c] = std::array{get<0>(m[0]), get<1>(m[0]), get<2>(m[0])};
+        auto [d, e, f] = std::array{get<0>(m[1]), get<1>(m[1]), get<2>(m[1])};
+        auto k = 1 / determinant(m);
+        return {{e * k, -b * k, (b * f - c * e) * k},
+                {-d * k, a * k, (c * d - a * f) * k}};
+    }
+    template <class T>
+    constexpr matrix<T, 3, 3> inverse(matrix<T, 3, 3> const& m) noexcept {
+        auto [a, b, c] = std::array{get<0>(m[0]), get<1>(m[0]), get<2>(m[0])};
+        auto [d, e, f] = std::array{get<0>(m[1]), get<1>(m[1]), get<2>(m[1])};
+        auto [g, h, i] = std::array{get<0>(m[2]), get<1>(m[2]), get<2>(m[2])};
+        auto k = 1 / determinant(m);
+        return {{(e * i - f * h) * k, (c * h - b * i) * k, (b * f - c * e) * k},
+                {(f * g - d * i) * k, (a * i - c * g) * k, (c * d - a * f) * k},
+                {(d * h - e * g) * k, (b * g - a * h) * k, (a * e - b * d) * k}};
+    }
+
+    // Affine maps of the plane.
+    template <class T>
+    constexpr matrix<T, 2, 3> translation(versor<T, 2> const& d) noexcept {
+        return {{1, 0, get<0>(d)}, {0, 1, get<1>(d)}};
+    }
+    template <class T>
+    constexpr matrix<T, 2, 3> scaling(T s) noexcept {
+        return {{s, 0, 0}, {0, s, 0}};
+    }
+    template <class T>
+    constexpr matrix<T, 2, 3> scaling(versor<T, 2> const& s) noexcept {
+        return {{get<0>(s), 0, 0}, {0, get<1>(s), 0}};
+    }
+    // counterclockwise by radians, in a y-up frame (clockwise on screen)
+    template <class T>
+    matrix<T, 2, 3> rotation(T radians) noexcept {
+        auto c = std::cos(radians);
+        auto s = std::sin(radians);
+        return {{c, -s, 0}, {s, c, 0}};
+    }
+
+    namespace detail
+    {
+        // out[i] = m * in[i] for i < n, rounded as the scalar operator*:
+        // lane r of a point sums m[r][0] x, m[r][1] y, ..., m[r][N] with
+        // simd::pairwise_sum.
+        //
+        // Bare 2D points: two of them (x0 y0 x1 y1) make one 4-lane vector;
+        // its x and y broadcast over each pair (x0 x0 x1 x1, y0 y0 y1 y1)
+        // are scaled by the columns of m repeated twice.  Two vectors a
+        // step keep both shuffle and multiply units busy.
+        //
+        // Points of 3 or 4 components: one point a vector, its components
+        // broadcast over all lanes; lanes past N keep the input.  A
+        // 3-component load takes the first component of the next point
+        // too, so the last point goes the scalar way.
+        //
+        // Anything else, and T without 4-lane vectors, is mapped a point at
+        // a time.
+        template <class T, size_t N, size_t M>
+        void transform_points(matrix<T, N, N + 1> const& m, versor<T, M> const* in, versor<T, M>* out, size_t n) noexcept {
+            using vector = typename simd::lanes<T, 4>::type;
+            size_t i = 0;
+            if constexpr (simd::native_v<T, 4> && N == 2 && M == 2) {
+                std::array<vector, 3> columns;
+                for (size_t j = 0; j < 3; ++j) columns[j] = vector{m[0][j], m[1][j], m[0][j], m[1][j]};
+                auto map = [&](vector v) noexcept {
+                    return simd::pairwise_sum(std::array{
+                        columns[0] * __builtin_shufflevector(v, v, 0, 0, 2, 2),
+                        columns[1] * __builtin_shufflevector(v, v, 1, 1, 3, 3),
+                        columns[2],
+                    });
+                };
+                for (; i + 4 <= n; i += 4) {
+                    vector v, w;
+                    __builtin_memcpy(&v, in[i].begin(), sizeof v);
+                    __builtin_memcpy(&w, in[i + 2].begin(), sizeof w);
+                    v = map(v);
+                    w = map(w);
+                    __builtin_memcpy(out[i].begin(), &v, sizeof v);
+                    __builtin_memcpy(out[i + 2].begin(), &w, sizeof w);
+                }
+            }
+            else if constexpr (simd::native_v<T, 4> && (M == 3 || M == 4)) {
+                std::array<vector, N + 1> columns{};
+                for (size_t j = 0; j <= N; ++j) {
+                    for (size_t r = 0; r < N; ++r) columns[j][r] = m[r][j];
+                }
+                for (; i + (M == 3) < n; ++i) {
+                    vector p;
+                    __builtin_memcpy(&p, in[i].begin(), sizeof p);
+                    auto q = [&]<size_t... J>(std::index_sequence<J...>) noexcept {
+                        return simd::pairwise_sum(std::array{
+                            columns[J] * __builtin_shufflevector(p, p, J, J, J, J)...,
+                            columns[N],
+                        });
+                    }(std::make_index_sequence<N>());
+                    // lanes N.. from p
+                    q = [&]<size_t... L>(std::index_sequence<L...>) noexcept {
+                        return __builtin_shufflevector(q, p, (L < N ? L : L + 4)...);
+                    }(std::make_index_sequence<4>());
+                    __builtin_memcpy(out[i].begin(), &q, sizeof (T) * M);
+                }
+            }
+            for (; i < n; ++i) out[i] = m * in[i];
+        }
+
+        template <class T, size_t N, size_t M>
+        void project_points(matrix<T, N, N> const& m, versor<T, M> const* in, versor<T, M>* out, size_t n) noexcept {
+            for (size_t i = 0; i < n; ++i) out[i] = project(m, in[i]);
+        }
+    } // ::detail
+
+    // Span kernels: out[i] = m * in[i], or project(m, in[i]), for every
+    // i < in.size(); out holds at least as many points and is either in
+    // itself or does not overlap it.  The pool overloads split the span
+    // into chunks over the pool's threads.
+    template <class T, size_t N, size_t M>
+    void transform(matrix<T, N, N + 1> const& m,
+                   std::type_identity_t<std::span<versor<T, M> const>> in, std::span<versor<T, M>> out) noexcept
+    {
+        detail::transform_points(m, in.data(), out.data(), in.size());
+    }
+    template <class T, size_t N, size_t M>
+    void transform(matrix<T, N, N + 1> const& m, std::span<versor<T, M>> points) noexcept {
+        detail::transform_points(m, points.data(), points.data(), points.size());
+    }
+    template <class T, size_t N, size_t M>
+    void transform(thread_pool& pool, matrix<T, N, N + 1> const& m,
+                   std::type_identity_t<std::span<versor<T, M> const>> in, std::span<versor<T, M>> out)
+    {
+        parallel_chunks(pool, in.size(), [&](size_t begin, size_t end) {
+            detail::transform_points(m, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+    template <class T, size_t N, size_t M>
+    void transform(thread_pool& pool, matrix<T, N, N + 1> const& m, std::span<versor<T, M>> points) {
+        transform(pool, m, points, points);
+    }
+
+    template <class T, size_t N, size_t M>
+    void project(matrix<T, N, N> const& m,
+                 std::type_identity_t<std::span<versor<T, M> const>> in, std::span<versor<T, M>> out) noexcept
+    {
+        detail::project_points(m, in.data(), out.data(), in.size());
+    }
+    template <class T, size_t N, size_t M>
+    void project(matrix<T, N, N> const& m, std::span<versor<T, M>> points) noexcept {
+        detail::project_points(m, points.data(), points.data(), points.size());
+    }
+    template <class T, size_t N, size_t M>
+    void project(thread_pool& pool, matrix<T, N, N> const& m,
+                 std::type_identity_t<std::span<versor<T, M> const>> in, std::span<versor<T, M>> out)
+    {
+        parallel_chunks(pool, in.size(), [&](size_t begin, size_t end) {
+            detail::project_points(m, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+    template <class T, size_t N, size_t M>
+    void project(thread_pool& pool, matrix<T, N, N> const& m, std::span<versor<T, M>> points) {
+        project(pool, m, points, points);
+    }
+} // ::aux
+
+#endif // INCLUDE_AUX_MATRIX_HPP
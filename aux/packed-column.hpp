@@ -0,0 +1,75 @@
+#ifndef INCLUDE_AUX_PACKED_COLUMN_HPP
+#define INCLUDE_AUX_PACKED_COLUMN_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include <aux/packed-tuple.hpp>
+
+namespace aux::inline tuple_support
+{
+    // Byte offset of field I inside packed_tuple<Args...>; the layout is the
+    // fields back to back with no padding.
+    template <size_t I, class... Args>
+    constexpr size_t packed_offset = []<size_t... J>(std::index_sequence<J...>) noexcept {
+        return (size_t{0} + ... + sizeof (std::tuple_element_t<J, std::tuple<Args...>>));
+    }(std::make_index_sequence<I>());
+
+    template <size_t I, class... Args>
+    using packed_field_t = std::tuple_element_t<I, std::tuple<Args...>>;
+
+    // dst[i] = get<I>(src[i]) for i < min(src.size(), dst.size()).  Every
+    // field sits at a compile-time offset in the record, so each copy is
+    // one unaligned load and store of sizeof (field) bytes.
+    template <size_t I, class... Args>
+    void gather(std::span<packed_tuple<Args...> const> src,
+                std::span<packed_field_t<I, Args...>> dst) noexcept
+    {
+        using record = packed_tuple<Args...>;
+        using field = packed_field_t<I, Args...>;
+        static_assert(std::is_trivially_copyable_v<field>);
+        static_assert(sizeof (record) == (sizeof (Args) + ...));
+        constexpr size_t stride = sizeof (record);
+        constexpr size_t offset = packed_offset<I, Args...>;
+
+        auto const* __restrict in = reinterpret_cast<std::byte const*>(src.data());
+        auto* __restrict out = dst.data();
+        size_t const n = std::min(src.size(), dst.size());
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(out + i, in + i * stride + offset, sizeof (field));
+        }
+    }
+
+    // get<I>(dst[i]) = src[i] for i < min(src.size(), dst.size()); the other
+    // fields of each record are left untouched.
+    template <size_t I, class... Args>
+    void scatter(std::span<packed_field_t<I, Args...> const> src,
+                 std::span<packed_tuple<Args...>> dst) noexcept
+    {
+        using record = packed_tuple<Args...>;
+        using field = packed_field_t<I, Args...>;
+        static_assert(std::is_trivially_copyable_v<field>);
+        static_assert(sizeof (record) == (sizeof (Args) + ...));
+        constexpr size_t stride = sizeof (record);
+        constexpr size_t offset = packed_offset<I, Args...>;
+
+        auto const* __restrict in = src.data();
+        auto* __restrict out = reinterpret_cast<std::byte*>(dst.data());
+        size_t const n = std::min(src.size(), dst.size());
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(out + i * stride + offset, in + i, sizeof (field));
+        }
+    }
+
+    // Convenience overloads deducing the record type from a mutable span.
+    template <size_t I, class... Args>
+    void gather(std::span<packed_tuple<Args...>> src, std::span<packed_field_t<I, Args...>> dst) noexcept {
+        gather<I, Args...>(std::span<packed_tuple<Args...> const>{src}, dst);
+    }
+} // namespace aux::inline tuple_support
+
+#endif // INCLUDE_AUX_PACKED_COLUMN_HPP
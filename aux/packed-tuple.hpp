@@ -95,6 +95,12 @@ namespace aux::inline tuple_support
     }
 } // namespace aux::inline tuple_support
 
+namespace aux
+{
+    template <class... Args>
+    constexpr bool enable_formatter<packed_tuple<Args...>> = true;
+}
+
 namespace std
 {
     template <class... Args>
@@ -0,0 +1,182 @@
+#ifndef INCLUDE_AUX_PERSISTENT_VECTOR_HPP
+#define INCLUDE_AUX_PERSISTENT_VECTOR_HPP
+
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <span>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
+namespace aux
+{
+    // Vector with value semantics whose copies share storage.  Elements
+    // live in fixed-size chunks, reached through a two-level radix tree
+    // (root -> leaf -> chunk) of reference-counted nodes, so a copy is one
+    // pointer copy whatever the size.  A write through a copy first clones
+    // the nodes on its path that are shared with other copies: one chunk,
+    // one leaf and the root, whichever element is touched; nodes owned by
+    // this copy alone are written in place.
+    //
+    // Copies may be read concurrently from several threads; writes to one
+    // copy need the usual exclusive access.
+    template <class T, size_t ChunkSize = 256, size_t Fanout = 256>
+    class persistent_vector {
+        static_assert(std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>);
+
+    public:
+        using value_type = T;
+        constexpr static size_t chunk_size = ChunkSize;
+        constexpr static size_t leaf_span = ChunkSize * Fanout;   // elements under one leaf
+
+    private:
+        struct chunk {
+            std::array<T, ChunkSize> items;
+        };
+        struct leaf {
+            std::array<std::shared_ptr<chunk>, Fanout> chunks;
+        };
+        struct root_node {
+            std::vector<std::shared_ptr<leaf>> leaves;
+        };
+
+    public:
+        persistent_vector() = default;
+
+    public:
+        size_t size() const noexcept { return count; }
+        bool empty() const noexcept { return count == 0; }
+
+        T const& operator[](size_t i) const noexcept {
+            return root->leaves[i / leaf_span]->chunks[i / ChunkSize % Fanout]->items[i % ChunkSize];
+        }
+        T const& at(size_t i) const {
+            if (i >= count) throw std::out_of_range("persistent_vector::at");
+            return (*this)[i];
+        }
+
+        // Writable element; clones whatever it shares on the way.
+        T& mutable_at(size_t i) {
+            if (i >= count) throw std::out_of_range("persistent_vector::mutable_at");
+            return writable(i);
+        }
+        void set(size_t i, T const& value) {
+            mutable_at(i) = value;
+        }
+
+        void push_back(T const& value) {
+            grow(count + 1);
+            writable(count) = value;
+            ++count;
+        }
+        void append(std::span<T const> values) {
+            grow(count + values.size());
+            for (size_t done = 0; done < values.size(); ) {
+                auto i = count + done;
+                auto n = std::min(values.size() - done, ChunkSize - i % ChunkSize);
+                std::copy_n(values.begin() + static_cast<ptrdiff_t>(done), n, &writable(i));
+                done += n;
+            }
+            count += values.size();
+        }
+
+        // Shrinking keeps the chunks; growing fills with T{}.
+        void resize(size_t n) {
+            if (n > count) {
+                grow(n);
+                for (auto i = count; i < n; ++i) writable(i) = T{};
+            }
+            count = n;
+        }
+        void clear() noexcept {
+            root.reset();
+            count = 0;
+        }
+
+        // Calls func(span) for the chunk-contiguous pieces of [first, last).
+        template <class Func>
+        void for_each_span(size_t first, size_t last, Func&& func) const {
+            last = std::min(last, count);
+            while (first < last) {
+                auto n = std::min(last - first, ChunkSize - first % ChunkSize);
+                func(std::span<T const>{&(*this)[first], n});
+                first += n;
+            }
+        }
+        // Calls func(span) for writable pieces of [first, last), cloning
+        // the shared chunks among them.
+        template <class Func>
+        void modify(size_t first, size_t last, Func&& func) {
+            last = std::min(last, count);
+            while (first < last) {
+                auto n = std::min(last - first, ChunkSize - first % ChunkSize);
+                func(std::span<T>{&writable(first), n});
+                first += n;
+            }
+        }
+
+        // Whether both share their whole storage (one is an unmodified
+        // copy of the other).
+        bool same_storage(persistent_vector const& rhs) const noexcept {
+            return root == rhs.root && count == rhs.count;
+        }
+
+        // Bytes of nodes not yet in seen, which it then records.  Summed
+        // over several copies with one set, it gives what they hold
+        // together; shared nodes are counted once.
+        size_t memory(std::unordered_set<void const*>& seen) const {
+            if (!root || !seen.insert(root.get()).second) return 0;
+            size_t ret = sizeof (root_node) + root->leaves.capacity() * sizeof (std::shared_ptr<leaf>);
+            for (auto const& l : root->leaves) {
+                if (!l || !seen.insert(l.get()).second) continue;
+                ret += sizeof (leaf);
+                for (auto const& c : l->chunks) {
+                    if (c && seen.insert(c.get()).second) ret += sizeof (chunk);
+                }
+            }
+            return ret;
+        }
+
+    private:
+        // Makes p refer to a node only this copy holds.
+        template <class Node>
+        static Node& own(std::shared_ptr<Node>& p) {
+            if (!p) {
+                p = std::make_shared<Node>();
+            }
+            else if (p.use_count() > 1) {
+                p = std::make_shared<Node>(*p);
+            }
+            else {
+                // use_count() is a relaxed load: pairs with the release of
+                // the reference another thread just dropped, so its reads
+                // of the node happen before these writes
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+            return *p;
+        }
+
+        // Room for n elements in the root.
+        void grow(size_t n) {
+            auto leaves = (n + leaf_span - 1) / leaf_span;
+            if (root && root->leaves.size() >= leaves) return;
+            own(root).leaves.resize(leaves);
+        }
+
+        T& writable(size_t i) {
+            auto& l = own(own(root).leaves[i / leaf_span]);
+            auto& c = own(l.chunks[i / ChunkSize % Fanout]);
+            return c.items[i % ChunkSize];
+        }
+
+    private:
+        std::shared_ptr<root_node> root;
+        size_t count = 0;
+    };
+} // ::aux
+
+#endif // INCLUDE_AUX_PERSISTENT_VECTOR_HPP
@@ -0,0 +1,237 @@
+#ifndef INCLUDE_AUX_RECORD_FILE_HPP
+#define INCLUDE_AUX_RECORD_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <span>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <concepts>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <aux/packed-tuple.hpp>
+
+namespace aux::inline tuple_support
+{
+    // On-disk layout: one record_file_header followed by raw
+    // packed_tuple<Args...> records, host byte order.
+    struct record_file_header {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t field_count;
+        uint32_t reserved;
+        uint64_t record_count;
+        uint8_t field_types[32];
+    };
+    static_assert(sizeof (record_file_header) == 64);
+
+    constexpr char record_file_magic[8] = {'C', 'R', 'S', 'X', 'R', 'E', 'C', '\0'};
+    constexpr uint32_t record_file_version = 1;
+
+    // kind in the high nibble, size in the low nibble
+    template <class T>
+    constexpr uint8_t record_field_code() noexcept {
+        static_assert(sizeof (T) < 16);
+        if constexpr (std::same_as<T, bool>) return 0x50 | sizeof (T);
+        else if constexpr (std::same_as<T, char>) return 0x40 | sizeof (T);
+        else if constexpr (std::floating_point<T>) return 0x30 | sizeof (T);
+        else if constexpr (std::unsigned_integral<T>) return 0x20 | sizeof (T);
+        else if constexpr (std::signed_integral<T>) return 0x10 | sizeof (T);
+        else static_assert(std::is_void_v<T>, "unsupported record field type");
+    }
+
+    template <class... Args>
+    constexpr record_file_header make_record_file_header(uint64_t record_count = 0) noexcept {
+        static_assert(sizeof... (Args) <= sizeof (record_file_header::field_types));
+        record_file_header ret{};
+        std::copy(std::begin(record_file_magic), std::end(record_file_magic), ret.magic);
+        ret.version = record_file_version;
+        ret.record_size = sizeof (packed_tuple<Args...>);
+        ret.field_count = sizeof... (Args);
+        ret.record_count = record_count;
+        size_t i = 0;
+        ((ret.field_types[i++] = record_field_code<Args>()), ...);
+        return ret;
+    }
+
+    // Appends records to a new record file through a large user-space
+    // buffer; the header's record count is rewritten on every flush.
+    template <class... Args>
+    class record_writer {
+    public:
+        using record_type = packed_tuple<Args...>;
+
+    public:
+        explicit record_writer(char const* path, size_t buffer_size = size_t{1} << 20)
+            : fd{::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)}
+        {
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), path);
+            }
+            buffer.reserve(buffer_size);
+            auto header = make_record_file_header<Args...>();
+            write_all(&header, sizeof (header));
+        }
+        record_writer(record_writer const&) = delete;
+        record_writer& operator=(record_writer const&) = delete;
+
+        ~record_writer() {
+            try {
+                flush();
+            }
+            catch (...) {
+            }
+            ::close(fd);
+        }
+
+    public:
+        size_t size() const noexcept { return count; }
+
+        void append(record_type const& r) {
+            if (buffer.capacity() - buffer.size() < sizeof (r)) {
+                drain();
+            }
+            auto bytes = reinterpret_cast<std::byte const*>(&r);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof (r));
+            ++count;
+        }
+        void append(std::span<record_type const> rs) {
+            auto bytes = std::as_bytes(rs);
+            if (buffer.capacity() - buffer.size() < bytes.size()) {
+                drain();
+            }
+            if (buffer.capacity() < bytes.size()) {
+                write_all(bytes.data(), bytes.size());
+            }
+            else {
+                buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+            }
+            count += rs.size();
+        }
+
+        void flush() {
+            drain();
+            auto header = make_record_file_header<Args...>(count);
+            if (::pwrite(fd, &header, sizeof (header), 0) != sizeof (header)) {
+                throw std::system_error(errno, std::generic_category(), "record_writer header");
+            }
+        }
+
+    private:
+        void drain() {
+            write_all(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+        void write_all(void const* data, size_t n) {
+            auto p = static_cast<char const*>(data);
+            while (n > 0) {
+                auto written = ::write(fd, p, n);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::system_error(errno, std::generic_category(), "record_writer");
+                }
+                p += written;
+                n -= static_cast<size_t>(written);
+            }
+        }
+
+    private:
+        int fd;
+        std::vector<std::byte> buffer;
+        size_t count = 0;
+    };
+
+    // Read-only memory mapping of a record file; records() is a view straight
+    // into the page cache, nothing is parsed or copied.  The record count is
+    // taken from the file size, so a file whose writer died before its last
+    // header update still exposes every complete record.
+    template <class... Args>
+    class record_file {
+    public:
+        using record_type = packed_tuple<Args...>;
+
+    public:
+        explicit record_file(char const* path) {
+            int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), path);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) < 0) {
+                auto err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), path);
+            }
+            length = static_cast<size_t>(st.st_size);
+            if (length < sizeof (record_file_header)) {
+                ::close(fd);
+                throw std::runtime_error("record_file: truncated header");
+            }
+            base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            auto err = errno;
+            ::close(fd);
+            if (base == MAP_FAILED) {
+                throw std::system_error(err, std::generic_category(), path);
+            }
+            auto expected = make_record_file_header<Args...>();
+            auto const& actual = header();
+            if (std::memcmp(actual.magic, expected.magic, sizeof (expected.magic)) != 0 ||
+                actual.version != expected.version ||
+                actual.record_size != expected.record_size ||
+                actual.field_count != expected.field_count ||
+                std::memcmp(actual.field_types, expected.field_types, sizeof (expected.field_types)) != 0)
+            {
+                ::munmap(base, length);
+                throw std::runtime_error("record_file: record layout mismatch");
+            }
+        }
+        record_file(record_file&& rhs) noexcept
+            : base{std::exchange(rhs.base, MAP_FAILED)}
+            , length{std::exchange(rhs.length, 0)}
+        {
+        }
+        record_file& operator=(record_file&& rhs) noexcept {
+            std::swap(base, rhs.base);
+            std::swap(length, rhs.length);
+            return *this;
+        }
+        ~record_file() {
+            if (base != MAP_FAILED) {
+                ::munmap(base, length);
+            }
+        }
+
+    public:
+        record_file_header const& header() const noexcept {
+            return *static_cast<record_file_header const*>(base);
+        }
+        std::span<record_type const> records() const noexcept {
+            auto first = static_cast<std::byte const*>(base) + sizeof (record_file_header);
+            return {reinterpret_cast<record_type const*>(first),
+                    (length - sizeof (record_file_header)) / sizeof (record_type)};
+        }
+
+        size_t size() const noexcept { return records().size(); }
+        auto begin() const noexcept { return records().begin(); }
+        auto end() const noexcept { return records().end(); }
+        auto const& operator[](size_t i) const noexcept { return records()[i]; }
+
+    private:
+        void* base = MAP_FAILED;
+        size_t length = 0;
+    };
+} // namespace aux::inline tuple_support
+
+#endif // INCLUDE_AUX_RECORD_FILE_HPP
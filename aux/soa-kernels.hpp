@@ -0,0 +1,197 @@
+#ifndef INCLUDE_AUX_SOA_KERNELS_HPP
+#define INCLUDE_AUX_SOA_KERNELS_HPP
+
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+#include <aux/versor.hpp>
+#include <aux/versor-soa.hpp>
+#include <aux/matrix.hpp>
+
+// CRISS_CROSS_SYCL is defined by the CMake option of the same name for
+// every SYCL target; without it, the default, the kernels are plain C++
+// split over an aux::thread_pool.  The SYCL path is experimental: it has
+// not been built with a DPC++ compiler yet.
+#if defined(CRISS_CROSS_SYCL)
+#include <sycl/sycl.hpp>
+#else
+#include <aux/thread-pool.hpp>
+#endif
+
+namespace aux
+{
+    // Where the kernels below run: a SYCL queue on the default device
+    // (ONEAPI_DEVICE_SELECTOR picks among several), or all cores of the
+    // host.
+    class compute {
+    public:
+#if defined(CRISS_CROSS_SYCL)
+        compute()
+            : queue{sycl::default_selector_v}
+        {
+        }
+        explicit compute(sycl::queue queue)
+            : queue{std::move(queue)}
+        {
+        }
+
+        std::string device() const {
+            return queue.get_device().get_info<sycl::info::device::name>();
+        }
+        sycl::queue& get_queue() noexcept { return queue; }
+#else
+        explicit compute(size_t concurrency = std::thread::hardware_concurrency())
+            : pool{concurrency}
+        {
+        }
+
+        std::string device() const {
+            return "host, " + std::to_string(pool.concurrency()) + " threads";
+        }
+        thread_pool& get_pool() noexcept { return pool; }
+#endif
+
+    private:
+#if defined(CRISS_CROSS_SYCL)
+        sycl::queue queue;
+#else
+        thread_pool pool;
+#endif
+    };
+
+    // Affine map of the plane by rows: p' = (m[0] . (p, 1), m[1] . (p, 1)).
+    using affine2 = matrix<float, 2, 3>;
+
+    // Applies m to every point in place.
+    inline void transform(compute& device, versor_soa<float, 2>& points, affine2 const& m) {
+        auto n = points.size();
+        if (n == 0) return;
+        float a = get<0>(m[0]), b = get<1>(m[0]), c = get<2>(m[0]);
+        float d = get<0>(m[1]), e = get<1>(m[1]), f = get<2>(m[1]);
+#if defined(CRISS_CROSS_SYCL)
+        sycl::buffer<float> xs{points.column(0).data(), sycl::range<1>{n}};
+        sycl::buffer<float> ys{points.column(1).data(), sycl::range<1>{n}};
+        device.get_queue().submit([&](sycl::handler& h) {
+            sycl::accessor x{xs, h, sycl::read_write};
+            sycl::accessor y{ys, h, sycl::read_write};
+            h.parallel_for(sycl::range<1>{n}, [=](sycl::id<1> i) {
+                float px = x[i], py = y[i];
+                x[i] = a * px + b * py + c;
+                y[i] = d * px + e * py + f;
+            });
+        });
+        // the buffers write back as they go out of scope
+#else
+        auto x = points.column(0).data();
+        auto y = points.column(1).data();
+        parallel_chunks(device.get_pool(), n, [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float px = x[i], py = y[i];
+                x[i] = a * px + b * py + c;
+                y[i] = d * px + e * py + f;
+            }
+        });
+#endif
+    }
+
+    // Smallest box holding every point, as (lo, hi); lo > hi when empty.
+    inline std::pair<versor<float, 2>, versor<float, 2>> bounds(compute& device, versor_soa<float, 2> const& points) {
+        constexpr auto inf = std::numeric_limits<float>::infinity();
+        float lo[2] = {inf, inf};
+        float hi[2] = {-inf, -inf};
+        auto n = points.size();
+        if (n != 0) {
+#if defined(CRISS_CROSS_SYCL)
+            sycl::buffer<float> xs{points.column(0).data(), sycl::range<1>{n}};
+            sycl::buffer<float> ys{points.column(1).data(), sycl::range<1>{n}};
+            sycl::buffer<float> lo_x{&lo[0], 1}, lo_y{&lo[1], 1}, hi_x{&hi[0], 1}, hi_y{&hi[1], 1};
+            device.get_queue().submit([&](sycl::handler& h) {
+                sycl::accessor x{xs, h, sycl::read_only};
+                sycl::accessor y{ys, h, sycl::read_only};
+                h.parallel_for(sycl::range<1>{n},
+                               sycl::reduction(lo_x, h, sycl::minimum<float>()),
+                               sycl::reduction(lo_y, h, sycl::minimum<float>()),
+                               sycl::reduction(hi_x, h, sycl::maximum<float>()),
+                               sycl::reduction(hi_y, h, sycl::maximum<float>()),
+                               [=](sycl::id<1> i, auto& lx, auto& ly, auto& hx, auto& hy) {
+                                   lx.combine(x[i]);
+                                   ly.combine(y[i]);
+                                   hx.combine(x[i]);
+                                   hy.combine(y[i]);
+                               });
+            });
+#else
+            auto x = points.column(0).data();
+            auto y = points.column(1).data();
+            std::mutex mutex;
+            parallel_chunks(device.get_pool(), n, [&](size_t begin, size_t end) {
+                float l[2] = {inf, inf};
+                float u[2] = {-inf, -inf};
+                for (size_t i = begin; i < end; ++i) {
+                    l[0] = std::min(l[0], x[i]);
+                    l[1] = std::min(l[1], y[i]);
+                    u[0] = std::max(u[0], x[i]);
+                    u[1] = std::max(u[1], y[i]);
+                }
+                std::lock_guard lock{mutex};
+                lo[0] = std::min(lo[0], l[0]);
+                lo[1] = std::min(lo[1], l[1]);
+                hi[0] = std::max(hi[0], u[0]);
+                hi[1] = std::max(hi[1], u[1]);
+            });
+#endif
+        }
+        // SYCL result buffers have written back on leaving the block
+        return {{lo[0], lo[1]}, {hi[0], hi[1]}};
+    }
+
+    // Premultiplied source-over of float RGBA planes: dst = src + dst * (1 - src.a),
+    // over the first min(dst.size(), src.size()) elements.
+    inline void blend(compute& device, versor_soa<float, 4>& dst, versor_soa<float, 4> const& src) {
+        auto n = std::min(dst.size(), src.size());
+        if (n == 0) return;
+#if defined(CRISS_CROSS_SYCL)
+        sycl::buffer<float> d0{dst.column(0).data(), sycl::range<1>{n}};
+        sycl::buffer<float> d1{dst.column(1).data(), sycl::range<1>{n}};
+        sycl::buffer<float> d2{dst.column(2).data(), sycl::range<1>{n}};
+        sycl::buffer<float> d3{dst.column(3).data(), sycl::range<1>{n}};
+        sycl::buffer<float> s0{src.column(0).data(), sycl::range<1>{n}};
+        sycl::buffer<float> s1{src.column(1).data(), sycl::range<1>{n}};
+        sycl::buffer<float> s2{src.column(2).data(), sycl::range<1>{n}};
+        sycl::buffer<float> s3{src.column(3).data(), sycl::range<1>{n}};
+        device.get_queue().submit([&](sycl::handler& h) {
+            sycl::accessor r{d0, h, sycl::read_write}, g{d1, h, sycl::read_write};
+            sycl::accessor b{d2, h, sycl::read_write}, a{d3, h, sycl::read_write};
+            sycl::accessor sr{s0, h, sycl::read_only}, sg{s1, h, sycl::read_only};
+            sycl::accessor sb{s2, h, sycl::read_only}, sa{s3, h, sycl::read_only};
+            h.parallel_for(sycl::range<1>{n}, [=](sycl::id<1> i) {
+                float k = 1 - sa[i];
+                r[i] = sr[i] + r[i] * k;
+                g[i] = sg[i] + g[i] * k;
+                b[i] = sb[i] + b[i] * k;
+                a[i] = sa[i] + a[i] * k;
+            });
+        });
+#else
+        float* d[4] = {dst.column(0).data(), dst.column(1).data(), dst.column(2).data(), dst.column(3).data()};
+        float const* s[4] = {src.column(0).data(), src.column(1).data(), src.column(2).data(), src.column(3).data()};
+        parallel_chunks(device.get_pool(), n, [&](size_t begin, size_t end) {
+            for (size_t c = 0; c < 4; ++c) {
+                auto dc = d[c];
+                auto sc = s[c];
+                auto sa = s[3];
+                for (size_t i = begin; i < end; ++i) {
+                    dc[i] = sc[i] + dc[i] * (1 - sa[i]);
+                }
+            }
+        });
+#endif
+    }
+} // ::aux
+
+#endif // INCLUDE_AUX_SOA_KERNELS_HPP
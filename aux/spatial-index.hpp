@@ -0,0 +1,259 @@
+#ifndef INCLUDE_AUX_SPATIAL_INDEX_HPP
+#define INCLUDE_AUX_SPATIAL_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include <aux/versor.hpp>
+
+namespace aux
+{
+    // Axis-aligned box, lo <= hi per axis.
+    struct bounding_box {
+        versor<float, 2> lo;
+        versor<float, 2> hi;
+
+        constexpr bool overlaps(bounding_box const& rhs) const noexcept {
+            return get<0>(lo) <= get<0>(rhs.hi) && get<0>(rhs.lo) <= get<0>(hi)
+                && get<1>(lo) <= get<1>(rhs.hi) && get<1>(rhs.lo) <= get<1>(hi);
+        }
+        // Squared distance from p to the box, 0 inside.
+        constexpr float distance2(versor<float, 2> const& p) const noexcept {
+            auto d = max(lo - p, max(p - hi, versor<float, 2>{0, 0}));
+            return inner(d, d);
+        }
+        constexpr versor<float, 2> center() const noexcept { return (lo + hi) * 0.5f; }
+    };
+
+    // Incrementally updated index of boxes keyed by caller-chosen dense ids
+    // (segment indices, say).  New and changed boxes go into a sparse
+    // uniform grid, which is cheap to update per input frame; commit()
+    // bulk-builds a BVH over everything and empties the grid.  Removing a
+    // committed box only marks it, so the tree stays valid until the next
+    // commit.  Queries look at both and report every matching id once, in
+    // no particular order.
+    class spatial_index {
+    public:
+        explicit spatial_index(float cell = 64.0f, size_t leaf = 8)
+            : cell{cell}
+            , leaf{std::max<size_t>(leaf, 1)}
+        {
+        }
+
+    public:
+        size_t size() const noexcept { return live; }
+        size_t hot() const noexcept { return hot_count; }              // ids in the grid
+        size_t committed() const noexcept { return tree_count; }       // ids in the tree
+        bool contains(uint32_t id) const noexcept { return id < entries.size() && entries[id].where != nowhere; }
+
+        // Adds id or moves it to a new box.
+        void insert(uint32_t id, bounding_box const& box) {
+            if (id >= entries.size()) entries.resize(static_cast<size_t>(id) + 1);
+            remove(id);
+            entries[id] = {box, 0, in_grid};
+            for_cells(box, [&](uint64_t key) { grid[key].push_back(id); });
+            ++hot_count;
+            ++live;
+        }
+
+        void remove(uint32_t id) noexcept {
+            if (!contains(id)) return;
+            auto& e = entries[id];
+            if (e.where == in_grid) {
+                for_cells(e.box, [&](uint64_t key) {
+                    auto& ids = grid.find(key)->second;
+                    *std::find(ids.begin(), ids.end(), id) = ids.back();
+                    ids.pop_back();
+                });
+                --hot_count;
+            }
+            else {
+                items[e.slot].id = removed;
+                --tree_count;
+            }
+            e.where = nowhere;
+            --live;
+        }
+
+        void clear() noexcept {
+            entries.clear();
+            for (auto& [key, ids] : grid) ids.clear();
+            nodes.clear();
+            items.clear();
+            live = hot_count = tree_count = 0;
+        }
+
+        // Rebuilds the tree over all live ids and empties the grid.
+        void commit() {
+            items.clear();
+            for (uint32_t id = 0; id < entries.size(); ++id) {
+                if (entries[id].where != nowhere) {
+                    entries[id].where = in_tree;
+                    items.push_back({entries[id].box, id});
+                }
+            }
+            for (auto& [key, ids] : grid) ids.clear();
+            hot_count = 0;
+            tree_count = items.size();
+            nodes.clear();
+            if (!items.empty()) build(0, items.size());
+            for (uint32_t i = 0; i < items.size(); ++i) entries[items[i].id].slot = i;
+        }
+
+        // Calls func(id) for every box overlapping range.
+        template <class Func>
+        void query(bounding_box const& range, Func&& func) const {
+            search(range, [&](uint32_t id, bounding_box const& box) { if (box.overlaps(range)) func(id); });
+        }
+
+        // Calls func(id) for every box within radius of p.
+        template <class Func>
+        void query(versor<float, 2> const& p, float radius, Func&& func) const {
+            versor<float, 2> r{radius, radius};
+            auto r2 = radius * radius;
+            search({p - r, p + r}, [&](uint32_t id, bounding_box const& box) { if (box.distance2(p) <= r2) func(id); });
+        }
+
+        // Calls func(id) for every box containing p.
+        template <class Func>
+        void query(versor<float, 2> const& p, Func&& func) const {
+            query(bounding_box{p, p}, std::forward<Func>(func));
+        }
+
+    private:
+        enum : uint8_t { nowhere, in_grid, in_tree };
+        struct entry {
+            bounding_box box;
+            uint32_t slot;    // into items while in the tree
+            uint8_t where = nowhere;
+        };
+        // Tree leaves hold copies of their boxes, so a leaf is one
+        // contiguous scan; a removed item keeps its place, id cleared.
+        struct item {
+            bounding_box box;
+            uint32_t id;
+        };
+        struct node {
+            bounding_box box;
+            uint32_t first;   // leaf: into items; inner: right child (left is next)
+            uint32_t count;   // 0 for inner nodes
+        };
+        static constexpr uint32_t removed = ~uint32_t{0};
+
+        static uint64_t key(int32_t x, int32_t y) noexcept {
+            return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+        }
+        versor<int32_t, 2> cell_of(versor<float, 2> const& p) const noexcept {
+            return {static_cast<int32_t>(std::floor(get<0>(p) / cell)), static_cast<int32_t>(std::floor(get<1>(p) / cell))};
+        }
+        template <class Func>
+        void for_cells(bounding_box const& box, Func&& func) const {
+            auto lo = cell_of(box.lo);
+            auto hi = cell_of(box.hi);
+            for (auto y = get<1>(lo); y <= get<1>(hi); ++y) {
+                for (auto x = get<0>(lo); x <= get<0>(hi); ++x) {
+                    func(key(x, y));
+                }
+            }
+        }
+
+        // Candidates overlapping range, each once: a box spanning several
+        // cells is reported from the cell holding the low corner of its
+        // overlap with the range only.
+        template <class Func>
+        void search(bounding_box const& range, Func&& func) const {
+            if (hot_count) {
+                auto lo = cell_of(range.lo);
+                auto hi = cell_of(range.hi);
+                auto cells = static_cast<uint64_t>(get<0>(hi) - get<0>(lo) + 1) * static_cast<uint64_t>(get<1>(hi) - get<1>(lo) + 1);
+                auto visit = [&](uint64_t k, std::vector<uint32_t> const& ids) {
+                    for (auto id : ids) {
+                        auto const& box = entries[id].box;
+                        auto corner = cell_of(max(box.lo, range.lo));
+                        if (key(get<0>(corner), get<1>(corner)) == k) func(id, box);
+                    }
+                };
+                if (cells <= grid.size()) {
+                    for_cells(range, [&](uint64_t k) {
+                        if (auto found = grid.find(k); found != grid.end()) visit(k, found->second);
+                    });
+                }
+                else {
+                    for (auto const& [k, ids] : grid) {
+                        int32_t x = static_cast<int32_t>(k >> 32), y = static_cast<int32_t>(k);
+                        if (x >= get<0>(lo) && x <= get<0>(hi) && y >= get<1>(lo) && y <= get<1>(hi)) visit(k, ids);
+                    }
+                }
+            }
+            if (tree_count) {
+                uint32_t stack[64];
+                size_t top = 0;
+                stack[top++] = 0;
+                while (top) {
+                    auto const& n = nodes[stack[--top]];
+                    if (!n.box.overlaps(range)) continue;
+                    if (n.count) {
+                        for (auto i = n.first; i < n.first + n.count; ++i) {
+                            if (items[i].id != removed) func(items[i].id, items[i].box);
+                        }
+                    }
+                    else {
+                        stack[top++] = n.first;
+                        stack[top++] = static_cast<uint32_t>(&n - nodes.data()) + 1;
+                    }
+                }
+            }
+        }
+
+        // Median split along the longer axis of the centres, depth first.
+        // Halving keeps the depth at log2(n / leaf), well inside the query
+        // stack.
+        uint32_t build(size_t first, size_t last) {
+            auto index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back({});
+            bounding_box box = items[first].box;
+            bounding_box centers{box.center(), box.center()};
+            for (auto i = first; i < last; ++i) {
+                auto const& b = items[i].box;
+                box = {min(box.lo, b.lo), max(box.hi, b.hi)};
+                centers = {min(centers.lo, b.center()), max(centers.hi, b.center())};
+            }
+            if (last - first <= leaf) {
+                nodes[index] = {box, static_cast<uint32_t>(first), static_cast<uint32_t>(last - first)};
+                return index;
+            }
+            auto extent = centers.hi - centers.lo;
+            auto axis = get<0>(extent) >= get<1>(extent) ? 0 : 1;
+            auto mid = first + (last - first) / 2;
+            auto begin = items.begin();
+            std::nth_element(begin + static_cast<ptrdiff_t>(first), begin + static_cast<ptrdiff_t>(mid), begin + static_cast<ptrdiff_t>(last),
+                             [axis](item const& a, item const& b) {
+                                 auto ca = a.box.center();
+                                 auto cb = b.box.center();
+                                 return axis == 0 ? get<0>(ca) < get<0>(cb) : get<1>(ca) < get<1>(cb);
+                             });
+            build(first, mid);
+            auto right = build(mid, last);
+            nodes[index] = {box, right, 0};
+            return index;
+        }
+
+    private:
+        float cell;
+        size_t leaf;
+        std::vector<entry> entries;                                  // by id
+        std::unordered_map<uint64_t, std::vector<uint32_t>> grid;    // cells are kept once created
+        std::vector<node> nodes;
+        std::vector<item> items;                                     // in tree order
+        size_t live = 0;
+        size_t hot_count = 0;
+        size_t tree_count = 0;
+    };
+} // ::aux
+
+#endif // INCLUDE_AUX_SPATIAL_INDEX_HPP
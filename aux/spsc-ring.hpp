@@ -0,0 +1,100 @@
+#ifndef INCLUDE_AUX_SPSC_RING_HPP
+#define INCLUDE_AUX_SPSC_RING_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <array>
+#include <span>
+#include <algorithm>
+#include <type_traits>
+
+namespace aux
+{
+    // Wait-free single-producer/single-consumer ring of trivially copyable
+    // values.  try_push is only called from one thread and drain from one
+    // other thread.  A push into a full ring is dropped and counted rather
+    // than blocking the producer.
+    template <class T, size_t Capacity>
+    class spsc_ring {
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0);
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        using value_type = T;
+        constexpr static size_t capacity() noexcept { return Capacity; }
+
+    public:
+        spsc_ring() = default;
+        spsc_ring(spsc_ring const&) = delete;
+        spsc_ring& operator=(spsc_ring const&) = delete;
+
+    public:
+        // producer side
+        bool try_push(T const& value) noexcept {
+            auto t = tail.load(std::memory_order_relaxed);
+            if (t - head_cache == Capacity) {
+                head_cache = head.load(std::memory_order_acquire);
+                if (t - head_cache == Capacity) {
+                    dropped_count.store(dropped_count.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            slots[t & (Capacity - 1)] = value;
+            tail.store(t + 1, std::memory_order_release);
+            pushed_count.store(pushed_count.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+            // head_cache may be stale; only pay for a fresh head load when the
+            // stale figure would raise the mark.
+            auto mark = high_water_mark.load(std::memory_order_relaxed);
+            if (t + 1 - head_cache > mark) {
+                head_cache = head.load(std::memory_order_acquire);
+                if (t + 1 - head_cache > mark) {
+                    high_water_mark.store(t + 1 - head_cache, std::memory_order_relaxed);
+                }
+            }
+            return true;
+        }
+
+        // consumer side: moves up to out.size() values, oldest first, and
+        // returns how many were moved.
+        size_t drain(std::span<T> out) noexcept {
+            auto h = head.load(std::memory_order_relaxed);
+            if (tail_cache - h < out.size()) {
+                tail_cache = tail.load(std::memory_order_acquire);
+            }
+            auto n = std::min(tail_cache - h, out.size());
+            auto first = h & (Capacity - 1);
+            auto split = std::min(n, Capacity - first);
+            std::copy_n(slots.begin() + first, split, out.begin());
+            std::copy_n(slots.begin(), n - split, out.begin() + split);
+            head.store(h + n, std::memory_order_release);
+            return n;
+        }
+
+    public:
+        // approximate from any thread
+        size_t size() const noexcept {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+        bool empty() const noexcept { return size() == 0; }
+
+        size_t pushed() const noexcept { return pushed_count.load(std::memory_order_relaxed); }
+        size_t dropped() const noexcept { return dropped_count.load(std::memory_order_relaxed); }
+        size_t high_water() const noexcept { return high_water_mark.load(std::memory_order_relaxed); }
+
+    private:
+        // producer-owned line
+        alignas (64) std::atomic<size_t> tail = 0;
+        size_t head_cache = 0;
+        std::atomic<size_t> pushed_count = 0;
+        std::atomic<size_t> dropped_count = 0;
+        std::atomic<size_t> high_water_mark = 0;
+        // consumer-owned line
+        alignas (64) std::atomic<size_t> head = 0;
+        size_t tail_cache = 0;
+        alignas (64) std::array<T, Capacity> slots;
+    };
+} // ::aux
+
+#endif // INCLUDE_AUX_SPSC_RING_HPP
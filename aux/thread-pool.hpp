@@ -0,0 +1,208 @@
+#ifndef INCLUDE_AUX_THREAD_POOL_HPP
+#define INCLUDE_AUX_THREAD_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <stop_token>
+#include <type_traits>
+#include <condition_variable>
+
+namespace aux
+{
+    // Fixed set of workers, one task deque each.  A worker pops its own
+    // deque from the back and steals from the front of the others when it
+    // runs dry.  The thread calling parallel_for works on the job too, so a
+    // pool of concurrency n runs n - 1 background threads.
+    class thread_pool {
+    public:
+        explicit thread_pool(size_t concurrency = std::thread::hardware_concurrency())
+        {
+            concurrency = std::max<size_t>(concurrency, 1);
+            for (size_t i = 0; i < concurrency; ++i) {
+                queues.push_back(std::make_unique<queue>());
+            }
+            for (size_t i = 1; i < concurrency; ++i) {
+                workers.emplace_back([this, i](std::stop_token stop) { work(i, stop); });
+            }
+        }
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+
+        ~thread_pool() {
+            for (auto& w : workers) {
+                w.request_stop();
+            }
+            {
+                std::lock_guard lock{sleep};
+            }
+            wake.notify_all();
+            workers.clear();
+        }
+
+    public:
+        size_t concurrency() const noexcept { return queues.size(); }
+
+        // Calls func(i) for every i < count and returns once all calls have
+        // finished.  Indices are handed out in chunks of grain; func must not
+        // throw.  May be called from inside a running func.
+        template <class Func>
+        void parallel_for(size_t count, Func&& func, size_t grain = 1) {
+            grain = std::max<size_t>(grain, 1);
+            if (count == 0) return;
+            if (workers.empty() || count <= grain) {
+                for (size_t i = 0; i < count; ++i) func(i);
+                return;
+            }
+            using func_type = std::remove_reference_t<Func>;
+            size_t chunks = (count + grain - 1) / grain;
+            job j{
+                [](void* context, size_t begin, size_t end) {
+                    auto& f = *static_cast<func_type*>(context);
+                    for (size_t i = begin; i < end; ++i) f(i);
+                },
+                const_cast<void*>(static_cast<void const*>(std::addressof(func))),
+                chunks,
+            };
+            size_t first = next_queue.fetch_add(1, std::memory_order_relaxed);
+            for (size_t c = 0; c < chunks; ++c) {
+                auto& q = *queues[(first + c) % queues.size()];
+                std::lock_guard lock{q.mutex};
+                q.tasks.push_back(task{&j, c * grain, std::min(count, (c + 1) * grain)});
+            }
+            queued.fetch_add(chunks, std::memory_order_release);
+            {
+                std::lock_guard lock{sleep};
+            }
+            wake.notify_all();
+
+            for (;;) {
+                auto seen = completed.load(std::memory_order_acquire);
+                if (j.pending.load(std::memory_order_acquire) == 0) break;
+                if (auto t = pop(0)) {
+                    run(*t);
+                }
+                else {
+                    completed.wait(seen, std::memory_order_acquire);
+                }
+            }
+        }
+
+    private:
+        struct job {
+            void (*invoke)(void*, size_t, size_t);
+            void* context;
+            std::atomic<size_t> pending;
+        };
+        struct task {
+            job* owner;
+            size_t begin;
+            size_t end;
+        };
+        // Double-ended ring of tasks; it grows to the largest job seen and
+        // never shrinks, so a steady stream of jobs allocates nothing.
+        class task_deque {
+        public:
+            bool empty() const noexcept { return count == 0; }
+            task const& front() const noexcept { return slots[head]; }
+            task const& back() const noexcept { return slots[(head + count - 1) % slots.size()]; }
+            void pop_front() noexcept {
+                head = (head + 1) % slots.size();
+                --count;
+            }
+            void pop_back() noexcept { --count; }
+            void push_back(task const& t) {
+                if (count == slots.size()) {
+                    std::vector<task> grown(std::max<size_t>(slots.size() * 2, 16));
+                    for (size_t i = 0; i < count; ++i) grown[i] = slots[(head + i) % slots.size()];
+                    slots.swap(grown);
+                    head = 0;
+                }
+                slots[(head + count) % slots.size()] = t;
+                ++count;
+            }
+
+        private:
+            std::vector<task> slots;
+            size_t head = 0;
+            size_t count = 0;
+        };
+        struct alignas (64) queue {
+            std::mutex mutex;
+            task_deque tasks;
+        };
+
+        std::optional<task> pop(size_t self) {
+            {
+                auto& q = *queues[self];
+                std::lock_guard lock{q.mutex};
+                if (!q.tasks.empty()) {
+                    auto t = q.tasks.back();
+                    q.tasks.pop_back();
+                    queued.fetch_sub(1, std::memory_order_relaxed);
+                    return t;
+                }
+            }
+            for (size_t k = 1; k < queues.size(); ++k) {
+                auto& q = *queues[(self + k) % queues.size()];
+                std::lock_guard lock{q.mutex};
+                if (!q.tasks.empty()) {
+                    auto t = q.tasks.front();
+                    q.tasks.pop_front();
+                    queued.fetch_sub(1, std::memory_order_relaxed);
+                    return t;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // The job lives on its caller's stack and may be gone as soon as its
+        // last chunk is counted down, so completion is signalled through the
+        // pool instead.
+        void run(task const& t) noexcept {
+            auto owner = t.owner;
+            owner->invoke(owner->context, t.begin, t.end);
+            if (owner->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                completed.fetch_add(1, std::memory_order_release);
+                completed.notify_all();
+            }
+        }
+
+        void work(size_t self, std::stop_token stop) {
+            while (!stop.stop_requested()) {
+                if (auto t = pop(self)) {
+                    run(*t);
+                    continue;
+                }
+                std::unique_lock lock{sleep};
+                wake.wait(lock, stop, [this] { return queued.load(std::memory_order_acquire) > 0; });
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<queue>> queues;   // [0] is shared by callers
+        std::atomic<size_t> queued = 0;
+        std::atomic<size_t> next_queue = 0;
+        std::atomic<uint32_t> completed = 0;
+        std::mutex sleep;
+        std::condition_variable_any wake;
+        std::vector<std::jthread> workers;
+    };
+
+    // Calls func(begin, end) over [0, n) on pool, in ranges of grain
+    // indices, for kernels that loop over a span themselves.
+    template <class Func>
+    void parallel_chunks(thread_pool& pool, size_t n, Func&& func, size_t grain = size_t{1} << 14) {
+        pool.parallel_for((n + grain - 1) / grain, [&](size_t c) {
+            func(c * grain, std::min(n, (c + 1) * grain));
+        });
+    }
+} // ::aux
+
+#endif // INCLUDE_AUX_THREAD_POOL_HPP
@@ -2,8 +2,16 @@
 #define INCLUDE_AUX_TUPLE_SUPPORT_HPP
 
 #include <tuple>
+#include <array>
 #include <concepts>
 #include <utility>
+#include <charconv>
+#include <algorithm>
+#include <system_error>
+#include <version>
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
 
 namespace aux
 {
@@ -19,6 +27,148 @@ namespace aux
     } && []<size_t... I>(std::index_sequence<I...>) noexcept {
         return (has_tuple_element<T, I>&& ...);
     }(std::make_index_sequence<std::tuple_size_v<T>>());
+
+    // Allocation- and locale-free text form of tuple_like values, using the
+    // same "(a b c)" syntax as operator<< below.  Plain char elements are
+    // written as the character itself, bool as 0/1, other arithmetic
+    // elements through std::to_chars (shortest round-trip form for floating
+    // point), nested tuple_like elements recursively.
+    template <class T>
+    std::to_chars_result to_chars(char* first, char* last, T const& t) noexcept
+        requires tuple_like<T>;
+
+    template <class T>
+    std::to_chars_result to_chars_element(char* first, char* last, T const& x) noexcept {
+        if constexpr (tuple_like<T>) {
+            return to_chars(first, last, x);
+        }
+        else if constexpr (std::same_as<T, char> || std::same_as<T, bool>) {
+            if (first == last) {
+                return {last, std::errc::value_too_large};
+            }
+            *first = std::same_as<T, bool> ? (x ? '1' : '0') : static_cast<char>(x);
+            return {first + 1, std::errc()};
+        }
+        else {
+            return std::to_chars(first, last, x);
+        }
+    }
+
+    template <class T>
+    std::to_chars_result to_chars(char* first, char* last, T const& t) noexcept
+        requires tuple_like<T>
+    {
+        auto put = [&](char c) noexcept {
+            if (first == last) return false;
+            *first++ = c;
+            return true;
+        };
+        auto element = [&](auto const& x) noexcept {
+            auto ret = to_chars_element(first, last, x);
+            first = ret.ptr;
+            return ret.ec == std::errc();
+        };
+        bool ok = put('(') && [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            return (((I == 0 || put(' ')) && element(get<I>(t))) && ...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>()) && put(')');
+        if (!ok) {
+            return {last, std::errc::value_too_large};
+        }
+        return {first, std::errc()};
+    }
+
+    // Writes the same text as to_chars through an output iterator.
+    template <class Out, class T>
+    Out write_to(Out out, T const& t)
+        requires tuple_like<T>;
+
+    template <class Out, class T>
+    Out write_element_to(Out out, T const& x) {
+        if constexpr (tuple_like<T>) {
+            return write_to(out, x);
+        }
+        else {
+            std::array<char, 64> buf;
+            auto ret = to_chars_element(buf.data(), buf.data() + buf.size(), x);
+            return std::copy(buf.data(), ret.ptr, out);
+        }
+    }
+
+    template <class Out, class T>
+    Out write_to(Out out, T const& t)
+        requires tuple_like<T>
+    {
+        *out++ = '(';
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((I == 0 ? void() : void(*out++ = ' '), out = write_element_to(out, get<I>(t))), ...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>());
+        *out++ = ')';
+        return out;
+    }
+
+    template <class T>
+    std::from_chars_result from_chars(char const* first, char const* last, T& t) noexcept
+        requires tuple_like<T>;
+
+    template <class T>
+    std::from_chars_result from_chars_element(char const* first, char const* last, T& x) noexcept {
+        if constexpr (tuple_like<T>) {
+            return from_chars(first, last, x);
+        }
+        else if constexpr (std::same_as<T, char> || std::same_as<T, bool>) {
+            if (first == last || (std::same_as<T, bool> && *first != '0' && *first != '1')) {
+                return {first, std::errc::invalid_argument};
+            }
+            x = std::same_as<T, bool> ? (*first == '1') : static_cast<T>(*first);
+            return {first + 1, std::errc()};
+        }
+        else {
+            return std::from_chars(first, last, x);
+        }
+    }
+
+    // Parses the "(a b c)" form written by to_chars; elements may be
+    // separated by any number of spaces.  On failure ptr points at the
+    // offending character and t is partially assigned.
+    template <class T>
+    std::from_chars_result from_chars(char const* first, char const* last, T& t) noexcept
+        requires tuple_like<T>
+    {
+        auto skip = [last](char const* p) noexcept {
+            while (p != last && *p == ' ') ++p;
+            return p;
+        };
+        first = skip(first);
+        if (first == last || *first != '(') {
+            return {first, std::errc::invalid_argument};
+        }
+        std::from_chars_result ret{first + 1, std::errc()};
+        auto element = [&]<size_t I>() noexcept {
+            std::remove_cvref_t<decltype (get<I>(t))> x{};
+            ret = from_chars_element(skip(ret.ptr), last, x);
+            if (ret.ec != std::errc()) return false;
+            get<I>(t) = x;
+            return true;
+        };
+        bool ok = [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            return (element.template operator()<I>() && ...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>());
+        if (!ok) {
+            return ret;
+        }
+        ret.ptr = skip(ret.ptr);
+        if (ret.ptr == last || *ret.ptr != ')') {
+            return {ret.ptr, std::errc::invalid_argument};
+        }
+        ++ret.ptr;
+        return ret;
+    }
+
+    // Opts a tuple_like type of aux into the std::formatter below; set next
+    // to each type's tuple_size.  Types aux does not own keep whatever the
+    // standard library makes of them.
+    template <class T>
+    constexpr bool enable_formatter = false;
 } // ::aux
 
 namespace std
@@ -34,4 +184,24 @@ namespace std
     }
 } // ::std
 
+#if defined(__cpp_lib_format)
+namespace std
+{
+    template <aux::tuple_like T>
+        requires aux::enable_formatter<T>
+    struct formatter<T, char> {
+        constexpr auto parse(format_parse_context& ctx) {
+            auto it = ctx.begin();
+            if (it != ctx.end() && *it != '}') {
+                throw format_error("aux::tuple_like takes no format spec");
+            }
+            return it;
+        }
+        auto format(T const& t, format_context& ctx) const {
+            return aux::write_to(ctx.out(), t);
+        }
+    };
+} // ::std
+#endif
+
 #endif // INCLUDE_AUX_TUPLE_SUPPORT_HPP
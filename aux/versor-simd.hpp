@@ -0,0 +1,162 @@
+#ifndef INCLUDE_AUX_VERSOR_SIMD_HPP
+#define INCLUDE_AUX_VERSOR_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// Lane-wise backend for aux::versor.
+// versor<T, N> shapes listed in native<> are loaded into a GCC/Clang vector
+// extension register, combined in one instruction and stored back.  Every
+// other shape, and every constant evaluation, stays on the recursive scalar
+// versor::apply.  Define AUX_VERSOR_SCALAR to force the scalar path.
+namespace aux::simd
+{
+    template <class T, size_t N>
+    struct native : std::false_type { };
+
+#if !defined(AUX_VERSOR_SCALAR) && defined(__GNUC__)
+    template <> struct native<float, 2> : std::true_type { };
+    template <> struct native<float, 4> : std::true_type { };
+    template <> struct native<float, 8> : std::true_type { };
+    template <> struct native<double, 2> : std::true_type { };
+    template <> struct native<double, 4> : std::true_type { };
+    template <> struct native<int32_t, 4> : std::true_type { };
+    template <> struct native<int32_t, 8> : std::true_type { };
+    template <> struct native<uint8_t, 4> : std::true_type { };
+    template <> struct native<uint8_t, 16> : std::true_type { };
+#endif
+
+    template <class T, size_t N>
+    constexpr bool native_v = native<T, N>::value;
+
+    template <class T, size_t N>
+    struct lanes {
+        typedef T type __attribute__((__vector_size__(sizeof (T) * N)));
+    };
+
+    // element functors of versor::apply that have a lane-wise counterpart.
+    // Operations are applied in place so that no vector value crosses a
+    // function boundary (keeps 256-bit lanes ABI-neutral without -mavx).
+    template <class Func>
+    struct lane_op { };
+    template <class T> struct lane_op<std::plus<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs += rhs; }
+    };
+    template <class T> struct lane_op<std::minus<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs -= rhs; }
+    };
+    template <class T> struct lane_op<std::multiplies<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs *= rhs; }
+    };
+    template <class T> struct lane_op<std::divides<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs /= rhs; }
+    };
+    template <class T> struct lane_op<std::bit_and<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs &= rhs; }
+    };
+    template <class T> struct lane_op<std::bit_or<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs |= rhs; }
+    };
+    template <class T> struct lane_op<std::bit_xor<T>> {
+        static constexpr size_t arity = 2;
+        static void on(auto& lhs, auto const& rhs) noexcept { lhs ^= rhs; }
+    };
+    template <class T> struct lane_op<std::negate<T>> {
+        static constexpr size_t arity = 1;
+        static void on(auto& lhs) noexcept { lhs = -lhs; }
+    };
+    template <class T> struct lane_op<std::bit_not<T>> {
+        static constexpr size_t arity = 1;
+        static void on(auto& lhs) noexcept { lhs = ~lhs; }
+    };
+
+    template <class Func, size_t Arity>
+    concept lane_wise = requires {
+        requires lane_op<std::remove_cvref_t<Func>>::arity == Arity;
+    };
+
+    // dst[i] = func(dst[i], rest[i]...) for all N lanes at once.
+    template <class T, size_t N, class Func, class... Rest>
+        requires lane_wise<Func, sizeof... (Rest) + 1>
+    inline void apply(Func&&, T* dst, Rest const*... rest) noexcept {
+        using vector = typename lanes<T, N>::type;
+        vector lhs;
+        vector rhs[sizeof... (rest) + 1];
+        __builtin_memcpy(&lhs, dst, sizeof (vector));
+        ((__builtin_memcpy(&rhs[0], rest, sizeof (vector))), ...);
+        if constexpr (sizeof... (rest) == 0) {
+            lane_op<std::remove_cvref_t<Func>>::on(lhs);
+        }
+        else {
+            lane_op<std::remove_cvref_t<Func>>::on(lhs, rhs[0]);
+        }
+        __builtin_memcpy(dst, &lhs, sizeof (vector));
+    }
+
+    // dst[i] *= s for all N lanes at once.
+    template <class T, size_t N>
+    inline void scale(T* dst, T s) noexcept {
+        using vector = typename lanes<T, N>::type;
+        vector lhs;
+        __builtin_memcpy(&lhs, dst, sizeof (vector));
+        lhs *= s;
+        __builtin_memcpy(dst, &lhs, sizeof (vector));
+    }
+
+    // Pairwise sum: x[i] + x[i + H] for the lower half H = ceil(n/2), then
+    // recurse.  This is the order the vector halving in inner() below uses,
+    // so the scalar and vector reductions round identically.
+    template <class T, size_t N>
+    constexpr T pairwise_sum(std::array<T, N> const& x) noexcept {
+        static_assert(N > 0);
+        if constexpr (N == 1) {
+            return x[0];
+        }
+        else {
+            constexpr size_t H = (N + 1) / 2;
+            std::array<T, H> y{};
+            for (size_t i = 0; i < H; ++i) {
+                y[i] = (i + H < N) ? static_cast<T>(x[i] + x[i + H]) : x[i];
+            }
+            return pairwise_sum(y);
+        }
+    }
+
+    template <class T, size_t N>
+    inline T horizontal_sum(typename lanes<T, N>::type const& v) noexcept {
+        if constexpr (N == 2) {
+            return static_cast<T>(v[0] + v[1]);
+        }
+        else {
+            typename lanes<T, N/2>::type lo, hi;
+            __builtin_memcpy(&lo, &v, sizeof (lo));
+            __builtin_memcpy(&hi, reinterpret_cast<char const*>(&v) + sizeof (lo), sizeof (hi));
+            lo += hi;
+            return horizontal_sum<T, N/2>(lo);
+        }
+    }
+
+    // sum of a[i] * b[i] over N lanes: one vector multiply, then horizontal
+    // adds by halving the register.
+    template <class T, size_t N>
+    inline T inner(T const* a, T const* b) noexcept {
+        using vector = typename lanes<T, N>::type;
+        vector lhs, rhs;
+        __builtin_memcpy(&lhs, a, sizeof (vector));
+        __builtin_memcpy(&rhs, b, sizeof (vector));
+        lhs *= rhs;
+        return horizontal_sum<T, N>(lhs);
+    }
+} // ::aux::simd
+
+#endif // INCLUDE_AUX_VERSOR_SIMD_HPP
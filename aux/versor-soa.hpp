@@ -0,0 +1,299 @@
+#ifndef INCLUDE_AUX_VERSOR_SOA_HPP
+#define INCLUDE_AUX_VERSOR_SOA_HPP
+
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <span>
+#include <memory>
+#include <new>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <aux/versor.hpp>
+
+namespace aux
+{
+    template <class T, size_t Align>
+    struct aligned_allocator {
+        static_assert(Align >= alignof (T) && (Align & (Align - 1)) == 0);
+
+        using value_type = T;
+        template <class U>
+        struct rebind { using other = aligned_allocator<U, Align>; };
+
+        constexpr aligned_allocator() noexcept = default;
+        template <class U>
+        constexpr aligned_allocator(aligned_allocator<U, Align> const&) noexcept { }
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof (T), std::align_val_t{Align}));
+        }
+        void deallocate(T* p, size_t) noexcept {
+            ::operator delete(p, std::align_val_t{Align});
+        }
+
+        template <class U>
+        constexpr bool operator==(aligned_allocator<U, Align> const&) const noexcept { return true; }
+    };
+
+    template <class Soa>
+    class versor_soa_reference;
+
+    // Structure-of-arrays storage for versor<T, N>: component C of every
+    // element lives in its own Align-aligned column.  Elements are handed out
+    // as versor_soa_reference proxies; arithmetic runs column by column.
+    template <class T, size_t N, size_t Align = 64>
+    class versor_soa {
+    public:
+        using value_type = versor<T, N>;
+        using element_type = T;
+        using column_type = std::vector<T, aligned_allocator<T, Align>>;
+        using reference = versor_soa_reference<versor_soa>;
+        using const_reference = versor_soa_reference<versor_soa const>;
+        using size_type = size_t;
+
+    public:
+        versor_soa() = default;
+        versor_soa(versor_soa const&) = default;
+        versor_soa(versor_soa&&) noexcept = default;
+        versor_soa& operator=(versor_soa const&) = default;
+        versor_soa& operator=(versor_soa&&) noexcept = default;
+        bool operator==(versor_soa const&) const = default;
+
+        explicit versor_soa(size_t n, value_type const& v = value_type())
+        {
+            resize(n, v);
+        }
+        explicit versor_soa(std::span<value_type const> src)
+        {
+            assign(src);
+        }
+
+    public:
+        size_t size() const noexcept { return columns[0].size(); }
+        bool empty() const noexcept { return columns[0].empty(); }
+        constexpr static size_t width() noexcept { return N; }
+
+        void reserve(size_t n) {
+            for (auto& col : columns) col.reserve(n);
+        }
+        void resize(size_t n, value_type const& v = value_type()) {
+            for (size_t c = 0; c < N; ++c) columns[c].resize(n, v[c]);
+        }
+        void clear() noexcept {
+            for (auto& col : columns) col.clear();
+        }
+        void push_back(value_type const& v) {
+            for (size_t c = 0; c < N; ++c) columns[c].push_back(v[c]);
+        }
+
+        void assign(std::span<value_type const> src) {
+            resize(src.size());
+            for (size_t c = 0; c < N; ++c) {
+                T* dst = column(c).data();
+                for (size_t i = 0; i < src.size(); ++i) dst[i] = src[i][c];
+            }
+        }
+        // Copies the first min(size(), dst.size()) elements into dst.
+        void copy_to(std::span<value_type> dst) const noexcept {
+            auto n = std::min(size(), dst.size());
+            for (size_t c = 0; c < N; ++c) {
+                T const* src = column(c).data();
+                for (size_t i = 0; i < n; ++i) dst[i][c] = src[i];
+            }
+        }
+
+    public:
+        template <size_t C>
+        std::span<T> column() noexcept {
+            static_assert(C < N);
+            return column(C);
+        }
+        template <size_t C>
+        std::span<T const> column() const noexcept {
+            static_assert(C < N);
+            return column(C);
+        }
+        std::span<T> column(size_t c) noexcept {
+            return {std::assume_aligned<Align>(columns[c].data()), columns[c].size()};
+        }
+        std::span<T const> column(size_t c) const noexcept {
+            return {std::assume_aligned<Align>(columns[c].data()), columns[c].size()};
+        }
+
+        reference operator[](size_t i) noexcept { return {this, i}; }
+        const_reference operator[](size_t i) const noexcept { return {this, i}; }
+
+        reference at(size_t i) {
+            if (this->size() <= i)
+                throw std::range_error("versor_soa index");
+            return (*this)[i];
+        }
+        const_reference at(size_t i) const {
+            if (this->size() <= i)
+                throw std::range_error("versor_soa index");
+            return (*this)[i];
+        }
+
+        reference front() noexcept { return (*this)[0]; }
+        const_reference front() const noexcept { return (*this)[0]; }
+        reference back() noexcept { return (*this)[size() - 1]; }
+        const_reference back() const noexcept { return (*this)[size() - 1]; }
+
+    public:
+        // dst[i] = func(dst[i], rest[i]...) for every component column.  Each
+        // of rest is either a versor_soa holding at least size() elements, a
+        // versor<T, N> broadcast to all elements, or a scalar T broadcast to
+        // all components; a shorter versor_soa throws std::length_error.
+        template <class Func, class... Rest>
+        auto& apply(Func&& func, Rest const&... rest) {
+            if ((... || (short_operand(rest)))) {
+                throw std::length_error("versor_soa operand size");
+            }
+            [&]<size_t... C>(std::index_sequence<C...>) noexcept {
+                (apply_column<C>(func, rest...), ...);
+            }(std::make_index_sequence<N>());
+            return *this;
+        }
+
+        auto& negate() noexcept { return apply(std::negate<T>()); }
+        auto& lognot() noexcept { return apply(std::bit_not<T>()); }
+
+    public:
+        auto operator+() const { return *this; }
+        auto operator-() const { return (+(*this)).negate(); }
+        auto operator~() const { return (+(*this)).lognot(); }
+
+        auto& operator+=(auto const& rhs) { return apply(std::plus<T>(), rhs); }
+        auto& operator-=(auto const& rhs) { return apply(std::minus<T>(), rhs); }
+        auto& operator*=(auto const& rhs) { return apply(std::multiplies<T>(), rhs); }
+        auto& operator/=(auto const& rhs) {
+            if constexpr (std::is_floating_point_v<T> && std::is_arithmetic_v<std::remove_cvref_t<decltype (rhs)>>) {
+                return (*this) *= static_cast<T>(1 / static_cast<T>(rhs)); // as versor::operator/=(value_type)
+            }
+            else {
+                return apply(std::divides<T>(), rhs);
+            }
+        }
+        auto& operator^=(auto const& rhs) { return apply(std::bit_xor<T>(), rhs); }
+        auto& operator|=(auto const& rhs) { return apply(std::bit_or<T>(), rhs); }
+        auto& operator&=(auto const& rhs) { return apply(std::bit_and<T>(), rhs); }
+
+        auto operator+(auto const& rhs) const { return (+(*this)) += rhs; }
+        auto operator-(auto const& rhs) const { return (+(*this)) -= rhs; }
+        auto operator*(auto const& rhs) const { return (+(*this)) *= rhs; }
+        auto operator/(auto const& rhs) const { return (+(*this)) /= rhs; }
+        auto operator^(auto const& rhs) const { return (+(*this)) ^= rhs; }
+        auto operator|(auto const& rhs) const { return (+(*this)) |= rhs; }
+        auto operator&(auto const& rhs) const { return (+(*this)) &= rhs; }
+
+        friend auto operator*(T s, versor_soa const& v) { return v * s; }
+
+    private:
+        bool short_operand(versor_soa const& src) const noexcept { return src.size() < size(); }
+        bool short_operand(auto const&) const noexcept { return false; }
+
+        template <size_t C>
+        static auto column_source(versor_soa const& src) noexcept {
+            return std::assume_aligned<Align>(src.columns[C].data());
+        }
+        template <size_t C>
+        static auto column_source(value_type const& src) noexcept { return get<C>(src); }
+        template <size_t C>
+        static auto column_source(T src) noexcept { return src; }
+
+        static auto element(T const* src, size_t i) noexcept { return src[i]; }
+        static auto element(T src, size_t) noexcept { return src; }
+
+        template <size_t C, class Func, class... Rest>
+        void apply_column(Func& func, Rest const&... rest) noexcept {
+            [&, n = size(), dst = std::assume_aligned<Align>(columns[C].data())](auto... src) noexcept {
+                for (size_t i = 0; i < n; ++i) {
+                    dst[i] = func(dst[i], element(src, i)...);
+                }
+            }(column_source<C>(rest)...);
+        }
+
+    private:
+        std::array<column_type, N> columns;
+    };
+
+    // Proxy for one element of a versor_soa; reads and writes go straight to
+    // the columns.  Converts to and assigns from versor<T, N>.
+    template <class Soa>
+    class versor_soa_reference {
+    public:
+        using versor_type = typename std::remove_const_t<Soa>::value_type;
+        using value_type = typename versor_type::value_type;
+
+    public:
+        constexpr versor_soa_reference(Soa* soa, size_t index) noexcept
+            : soa{soa}
+            , index{index}
+        {
+        }
+        constexpr versor_soa_reference(versor_soa_reference const&) = default;
+
+        auto& operator=(versor_type const& v) const noexcept
+            requires (!std::is_const_v<Soa>)
+        {
+            for (size_t c = 0; c < size(); ++c) (*this)[c] = v[c];
+            return *this;
+        }
+        auto& operator=(versor_soa_reference const& rhs) const noexcept
+            requires (!std::is_const_v<Soa>)
+        {
+            return *this = rhs.load();
+        }
+
+        operator versor_type() const noexcept { return load(); }
+
+        versor_type load() const noexcept {
+            return [this]<size_t... I>(std::index_sequence<I...>) noexcept {
+                return versor_type{this->template get<I>()...};
+            }(std::make_index_sequence<size()>());
+        }
+
+        bool operator==(versor_type const& rhs) const noexcept { return load() == rhs; }
+
+    public:
+        constexpr static size_t size() noexcept { return std::tuple_size_v<versor_type>; }
+
+        template <size_t I>
+        auto& get() const noexcept {
+            return soa->template column<I>()[index];
+        }
+        template <size_t I>
+        friend auto& get(versor_soa_reference const& r) noexcept { return r.get<I>(); }
+
+        auto& operator[](size_t c) const noexcept { return soa->column(c)[index]; }
+
+    private:
+        Soa* soa;
+        size_t index;
+    };
+
+    template <class Soa>
+    constexpr bool enable_formatter<versor_soa_reference<Soa>> = true;
+} // ::aux
+
+namespace std
+{
+    template <class Soa>
+    struct tuple_size<aux::versor_soa_reference<Soa>> {
+        static constexpr auto value = aux::versor_soa_reference<Soa>::size();
+    };
+    template <class Soa>
+    constexpr size_t tuple_size_v<aux::versor_soa_reference<Soa>> = tuple_size<aux::versor_soa_reference<Soa>>::value;
+
+    template <size_t I, class Soa>
+    struct tuple_element<I, aux::versor_soa_reference<Soa>> {
+        using type = typename aux::versor_soa_reference<Soa>::value_type;
+    };
+} // namespace std
+
+#endif // INCLUDE_AUX_VERSOR_SOA_HPP
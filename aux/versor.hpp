@@ -6,11 +6,26 @@
 #include <iosfwd>
 #include <functional>
 #include <stdexcept>
+#include <concepts>
+#include <tuple>
+#include <array>
+#include <span>
+#include <cmath>
+#include <algorithm>
 
 #include <aux/tuple-support.hpp>
+#include <aux/versor-simd.hpp>
 
 namespace aux
 {
+    // Node of a lazy versor expression (see lazy() below).
+    template <class E>
+    concept lazy_versor = requires (E const& e) {
+        typename E::value_type;
+        { E::size() } -> std::same_as<size_t>;
+        { e.template eval<0>() } -> std::same_as<typename E::value_type>;
+    };
+
     template <class T, size_t N>
     struct versor : versor<T, N-1> {
     public:
@@ -37,11 +52,20 @@ namespace aux
 
     public:
         constexpr versor(auto... args) noexcept
+            requires (std::constructible_from<T, decltype (args)> && ...)
         : versor{{static_cast<T>(args)...}, std::make_index_sequence<N-1>()}
         {
             static_assert(sizeof... (args) <= N);
         }
 
+        template <lazy_versor E>
+        constexpr versor(E const& e) noexcept
+            : versor{e, std::make_index_sequence<N>()}
+        {
+            static_assert(E::size() == N);
+            static_assert(std::same_as<typename E::value_type, T>);
+        }
+
     private:
         constexpr static auto at(std::initializer_list<T> const& args, size_t i) noexcept {
             return (i < args.size()) ? *(args.begin() + i) : T();
@@ -51,6 +75,11 @@ namespace aux
             : base_type{at(args, I)...}, last{at(args, N-1)}
         {
         }
+        template <class E, size_t... I>
+        constexpr versor(E const& e, std::index_sequence<I...>) noexcept
+            : versor{e.template eval<I>()...}
+        {
+        }
 
     public:
         template <size_t I>
@@ -96,6 +125,14 @@ namespace aux
     public:
         template <class Func, class... Rest>
         constexpr auto& apply(Func&& func, Rest&&... rest) noexcept {
+            if !consteval {
+                if constexpr (simd::native_v<T, N> && simd::lane_wise<Func, sizeof... (Rest) + 1> &&
+                              (std::same_as<std::remove_cvref_t<Rest>, versor> && ...))
+                {
+                    simd::apply<T, N>(func, this->begin(), rest.begin()...);
+                    return *this;
+                }
+            }
             this->last = func(this->last, rest.last...);
             if constexpr ((std::is_rvalue_reference_v<Rest> && ...)) {
                 base_type::apply(std::forward<Func>(func), std::move(static_cast<base_type&>(rest))...);
@@ -118,12 +155,34 @@ namespace aux
         constexpr auto& operator*=(auto&& rhs) noexcept { return apply(std::multiplies<T>(), rhs); }
         constexpr auto& operator/=(auto&& rhs) noexcept { return apply(std::divides<T>(), rhs); }
 
-        constexpr auto operator+(auto&& rhs) const noexcept { return (+(*this)) += rhs; }
-        constexpr auto operator-(auto&& rhs) const noexcept { return (+(*this)) -= rhs; }
-        constexpr auto operator*(auto&& rhs) const noexcept { return (+(*this)) *= rhs; }
-        constexpr auto operator/(auto&& rhs) const noexcept { return (+(*this)) /= rhs; }
+        constexpr auto operator+(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) += rhs;
+        }
+        constexpr auto operator-(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) -= rhs;
+        }
+        constexpr auto operator*(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) *= rhs;
+        }
+        constexpr auto operator/(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) /= rhs;
+        }
 
         constexpr auto& operator*=(value_type s) noexcept {
+            if !consteval {
+                if constexpr (simd::native_v<T, N>) {
+                    simd::scale<T, N>(this->begin(), s);
+                    return *this;
+                }
+            }
             return apply([s](value_type x) noexcept {
                 return x * s;
             });
@@ -139,9 +198,21 @@ namespace aux
         constexpr auto& operator|=(auto&& rhs) noexcept { return apply(std::bit_or<T>(), rhs); }
         constexpr auto& operator&=(auto&& rhs) noexcept { return apply(std::bit_and<T>(), rhs); }
 
-        constexpr auto operator^(auto&& rhs) const noexcept { return (+(*this)) ^= rhs; }
-        constexpr auto operator|(auto&& rhs) const noexcept { return (+(*this)) |= rhs; }
-        constexpr auto operator&(auto&& rhs) const noexcept { return (+(*this)) &= rhs; }
+        constexpr auto operator^(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) ^= rhs;
+        }
+        constexpr auto operator|(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) |= rhs;
+        }
+        constexpr auto operator&(auto&& rhs) const noexcept
+            requires (!lazy_versor<std::remove_cvref_t<decltype (rhs)>>)
+        {
+            return (+(*this)) &= rhs;
+        }
     };
 
     template <class T>
@@ -158,8 +229,232 @@ namespace aux
 
     protected:
         constexpr auto& apply(auto&&...) noexcept { return *this; }
-        constexpr friend T inner(versor const&, versor const&) noexcept { return T(); }
     };
+
+    // Lazy expressions.
+    // lazy(v) lifts a versor into an expression node.  The arithmetic and
+    // bitwise operators applied to nodes build an expression tree instead of
+    // versor temporaries; converting the tree to a versor evaluates it in a
+    // single pass, one component at a time, with the same per-step rounding
+    // as the eager operators.  Nodes refer to lvalue operands, so a tree must
+    // not outlive the versors it was built from.
+    template <class T, size_t N, class Ref>
+    struct versor_terminal {
+        using value_type = T;
+        constexpr static size_t size() noexcept { return N; }
+        template <size_t I>
+        constexpr T eval() const noexcept { return get<I>(ref); }
+
+        Ref ref;
+    };
+
+    template <class T, size_t N>
+    struct versor_scalar {
+        using value_type = T;
+        constexpr static size_t size() noexcept { return N; }
+        template <size_t>
+        constexpr T eval() const noexcept { return s; }
+
+        T s;
+    };
+
+    template <class T, size_t N, class Func, class... Args>
+    struct versor_expression {
+        using value_type = T;
+        constexpr static size_t size() noexcept { return N; }
+        template <size_t I>
+        constexpr T eval() const noexcept {
+            return std::apply([](auto const&... arg) noexcept {
+                return static_cast<T>(Func()(arg.template eval<I>()...));
+            }, args);
+        }
+
+        std::tuple<Args...> args;
+    };
+
+    template <class T, size_t N>
+    constexpr auto lazy(versor<T, N> const& v) noexcept {
+        return versor_terminal<T, N, versor<T, N> const&>{v};
+    }
+    template <class T, size_t N>
+    constexpr auto lazy(versor<T, N>&& v) noexcept {
+        return versor_terminal<T, N, versor<T, N>>{std::move(v)};
+    }
+
+    template <class X>
+    concept lazy_operand = lazy_versor<X> || requires (X const& x) {
+        { lazy(x) } -> lazy_versor;
+    };
+
+    template <class L, class R>
+    concept lazy_operands = (lazy_versor<L> && lazy_operand<R>) || (lazy_operand<L> && lazy_versor<R>);
+
+    template <class L, class R>
+    concept lazy_scaling = lazy_versor<L> && std::convertible_to<R, typename L::value_type> && !lazy_operand<R>;
+
+    template <template <class> class Func, class... Args>
+    constexpr auto lazy_combine(Args const&... args) noexcept {
+        constexpr auto lift = [](auto const& x) noexcept {
+            if constexpr (lazy_versor<std::remove_cvref_t<decltype (x)>>) {
+                return x;
+            }
+            else {
+                return lazy(x);
+            }
+        };
+        using E = std::tuple_element_t<0, std::tuple<decltype (lift(args))...>>;
+        static_assert(((decltype (lift(args))::size() == E::size()) && ...));
+        static_assert((std::same_as<typename decltype (lift(args))::value_type, typename E::value_type> && ...));
+        return versor_expression<typename E::value_type, E::size(),
+                                 Func<typename E::value_type>,
+                                 decltype (lift(args))...>{{lift(args)...}};
+    }
+    template <template <class> class Func, lazy_versor E>
+    constexpr auto lazy_combine(E const& e, typename E::value_type s) noexcept {
+        using T = typename E::value_type;
+        return versor_expression<T, E::size(), Func<T>, E, versor_scalar<T, E::size()>>{{e, {s}}};
+    }
+
+    template <lazy_versor E>
+    constexpr auto operator-(E const& e) noexcept { return lazy_combine<std::negate>(e); }
+    template <lazy_versor E>
+    constexpr auto operator~(E const& e) noexcept { return lazy_combine<std::bit_not>(e); }
+
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator+(L const& l, R const& r) noexcept { return lazy_combine<std::plus>(l, r); }
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator-(L const& l, R const& r) noexcept { return lazy_combine<std::minus>(l, r); }
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator*(L const& l, R const& r) noexcept { return lazy_combine<std::multiplies>(l, r); }
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator/(L const& l, R const& r) noexcept { return lazy_combine<std::divides>(l, r); }
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator^(L const& l, R const& r) noexcept { return lazy_combine<std::bit_xor>(l, r); }
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator|(L const& l, R const& r) noexcept { return lazy_combine<std::bit_or>(l, r); }
+    template <class L, class R> requires lazy_operands<L, R>
+    constexpr auto operator&(L const& l, R const& r) noexcept { return lazy_combine<std::bit_and>(l, r); }
+
+    template <class L, class S> requires lazy_scaling<L, S>
+    constexpr auto operator*(L const& l, S s) noexcept {
+        return lazy_combine<std::multiplies>(l, static_cast<typename L::value_type>(s));
+    }
+    template <class L, class S> requires lazy_scaling<L, S>
+    constexpr auto operator*(S s, L const& l) noexcept { return l * s; }
+    template <class L, class S> requires lazy_scaling<L, S>
+    constexpr auto operator/(L const& l, S s) noexcept {
+        using T = typename L::value_type;
+        return l * static_cast<T>(1 / static_cast<T>(s)); // as versor::operator/=(value_type)
+    }
+
+    // Reductions.
+    // Sums run pairwise (see simd::pairwise_sum), on the vector backend at
+    // run time and on the scalar recursion during constant evaluation; both
+    // round identically.
+    template <class T, size_t N>
+    constexpr T inner(versor<T, N> const& a, versor<T, N> const& b) noexcept {
+        if !consteval {
+            if constexpr (simd::native_v<T, N>) {
+                return simd::inner<T, N>(a.begin(), b.begin());
+            }
+        }
+        return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            return simd::pairwise_sum(std::array<T, N>{static_cast<T>(get<I>(a) * get<I>(b))...});
+        }(std::make_index_sequence<N>());
+    }
+    template <class T, size_t N>
+    constexpr T norm2(versor<T, N> const& v) noexcept { return inner(v, v); }
+    template <class T, size_t N>
+    constexpr auto norm(versor<T, N> const& v) noexcept { return std::sqrt(norm2(v)); }
+    template <class T, size_t N>
+    constexpr T distance2(versor<T, N> const& a, versor<T, N> const& b) noexcept { return norm2(a - b); }
+    template <class T, size_t N>
+    constexpr auto distance(versor<T, N> const& a, versor<T, N> const& b) noexcept { return norm(a - b); }
+
+    template <class T, size_t N>
+    constexpr T min(versor<T, N> const& v) noexcept {
+        return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            T ret = get<0>(v);
+            ((ret = (get<I>(v) < ret) ? get<I>(v) : ret), ...);
+            return ret;
+        }(std::make_index_sequence<N>());
+    }
+    template <class T, size_t N>
+    constexpr T max(versor<T, N> const& v) noexcept {
+        return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            T ret = get<0>(v);
+            ((ret = (ret < get<I>(v)) ? get<I>(v) : ret), ...);
+            return ret;
+        }(std::make_index_sequence<N>());
+    }
+    template <class T, size_t N>
+    constexpr auto min(versor<T, N> const& a, versor<T, N> const& b) noexcept {
+        return (+a).apply([](T x, T y) noexcept { return (y < x) ? y : x; }, b);
+    }
+    template <class T, size_t N>
+    constexpr auto max(versor<T, N> const& a, versor<T, N> const& b) noexcept {
+        return (+a).apply([](T x, T y) noexcept { return (x < y) ? y : x; }, b);
+    }
+
+    // a + (b - a) * t, fused into one pass over the components.
+    template <class T, size_t N>
+    constexpr versor<T, N> lerp(versor<T, N> const& a, versor<T, N> const& b, T t) noexcept {
+        return lazy(a) + (lazy(b) - a) * t;
+    }
+    // a * b + c per component, rounded once for floating point T.
+    template <class T, size_t N>
+    constexpr versor<T, N> fma(versor<T, N> const& a, versor<T, N> const& b, versor<T, N> const& c) noexcept {
+        return [&]<size_t... I>(std::index_sequence<I...>) noexcept {
+            if constexpr (std::is_floating_point_v<T>) {
+                return versor<T, N>{std::fma(get<I>(a), get<I>(b), get<I>(c))...};
+            }
+            else {
+                return versor<T, N>{get<I>(a) * get<I>(b) + get<I>(c)...};
+            }
+        }(std::make_index_sequence<N>());
+    }
+
+    // Batched reductions over spans of versors; out[i] receives the result
+    // for the i-th pair, for i < min(a.size(), b.size(), out.size()).  The
+    // versor type comes from the first span, const or not and of any
+    // extent; the others convert to it.
+    template <class V, size_t E, class T = typename std::remove_const_t<V>::value_type,
+              size_t N = std::tuple_size_v<std::remove_const_t<V>>>
+        requires std::same_as<std::remove_const_t<V>, versor<T, N>>
+    void inner(std::span<V, E> a, std::type_identity_t<std::span<versor<T, N> const>> b,
+               std::type_identity_t<std::span<T>> out) noexcept
+    {
+        auto n = std::min({a.size(), b.size(), out.size()});
+        for (size_t i = 0; i < n; ++i) out[i] = inner(a[i], b[i]);
+    }
+    template <class V, size_t E, class T = typename std::remove_const_t<V>::value_type,
+              size_t N = std::tuple_size_v<std::remove_const_t<V>>>
+        requires std::same_as<std::remove_const_t<V>, versor<T, N>>
+    void distance(std::span<V, E> a, std::type_identity_t<std::span<versor<T, N> const>> b,
+                  std::type_identity_t<std::span<T>> out) noexcept
+    {
+        auto n = std::min({a.size(), b.size(), out.size()});
+        for (size_t i = 0; i < n; ++i) out[i] = distance(a[i], b[i]);
+    }
+    template <class V, size_t E, class T = typename std::remove_const_t<V>::value_type,
+              size_t N = std::tuple_size_v<std::remove_const_t<V>>>
+        requires std::same_as<std::remove_const_t<V>, versor<T, N>>
+    void norm(std::span<V, E> v, std::type_identity_t<std::span<T>> out) noexcept {
+        auto n = std::min(v.size(), out.size());
+        for (size_t i = 0; i < n; ++i) out[i] = norm(v[i]);
+    }
+    // total length of the polyline through points
+    template <class V, size_t E, class T = typename std::remove_const_t<V>::value_type,
+              size_t N = std::tuple_size_v<std::remove_const_t<V>>>
+        requires std::same_as<std::remove_const_t<V>, versor<T, N>>
+    T length(std::span<V, E> points) noexcept {
+        T ret{};
+        for (size_t i = 1; i < points.size(); ++i) ret += distance(points[i - 1], points[i]);
+        return ret;
+    }
+
+    template <class T, size_t N>
+    constexpr bool enable_formatter<versor<T, N>> = true;
 } // ::aux
 
 // WIP. experimental tuple support
@@ -176,6 +471,12 @@ namespace std
     struct tuple_element<I, aux::versor<T, N>> {
         using type = T;
     };
+
+#if defined(__cpp_lib_format_ranges)
+    // formatted as tuple_like "(a b c)", not as a range "[a, b, c]"
+    template <class T, size_t N>
+    constexpr range_format format_kind<aux::versor<T, N>> = range_format::disabled;
+#endif
 } // namespace std
 
 
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include "blend.hpp"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    // One 4K layer composited onto another, bytes/second over both layers.
+    constexpr size_t pixels = 3840 * 2160;
+
+    std::vector<criss_cross::pixel> random_layer(unsigned seed) {
+        std::mt19937 gen{seed};
+        std::uniform_int_distribution<int> a{0, 255};
+        std::vector<criss_cross::pixel> ret(pixels);
+        for (auto& p : ret) {
+            auto alpha = a(gen);
+            std::uniform_int_distribution<int> c{0, alpha};
+            p = criss_cross::pixel{c(gen), c(gen), c(gen), alpha};
+        }
+        return ret;
+    }
+
+    template <void (*Op)(std::span<criss_cross::pixel>, std::span<criss_cross::pixel const>)>
+    void blend_layers(benchmark::State& state) {
+        auto dst = random_layer(1);
+        auto src = random_layer(2);
+        for (auto _ : state) {
+            Op(dst, src);
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * pixels * 2 * sizeof (criss_cross::pixel)));
+        state.SetLabel(criss_cross::blend_kernels);
+    }
+
+    void blend_dab(benchmark::State& state) {
+        auto dst = random_layer(1);
+        std::vector<uint8_t> mask(pixels);
+        std::mt19937 gen{3};
+        for (auto& m : mask) m = static_cast<uint8_t>(gen());
+        for (auto _ : state) {
+            criss_cross::dab(dst, mask, criss_cross::pixel{0x10, 0x18, 0x20, 0xe0});
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * pixels * (sizeof (criss_cross::pixel) + 1)));
+        state.SetLabel(criss_cross::blend_kernels);
+    }
+} // namespace
+
+BENCHMARK(blend_layers<criss_cross::source_over>)->Unit(benchmark::kMillisecond);
+BENCHMARK(blend_layers<criss_cross::multiply>)->Unit(benchmark::kMillisecond);
+BENCHMARK(blend_layers<criss_cross::erase>)->Unit(benchmark::kMillisecond);
+BENCHMARK(blend_dab)->Unit(benchmark::kMillisecond);
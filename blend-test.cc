@@ -0,0 +1,123 @@
+
+#include <gtest/gtest.h>
+
+#include "blend.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class blend_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+using criss_cross::pixel;
+
+namespace
+{
+    std::vector<pixel> random_pixels(size_t n, std::mt19937& gen) {
+        std::vector<pixel> ret(n);
+        for (auto& p : ret) {
+            auto a = std::uniform_int_distribution<int>(0, 255)(gen);
+            if (a > 200) a = 255;
+            if (a < 20) a = 0;
+            std::uniform_int_distribution<int> c(0, a);
+            p = pixel{c(gen), c(gen), c(gen), a};
+        }
+        return ret;
+    }
+}
+
+TEST_F(blend_test, div255) {
+    for (uint32_t x = 0; x <= 255 * 255; ++x) {
+        ASSERT_EQ(criss_cross::div255(x), static_cast<uint32_t>(std::lround(x / 255.0))) << x;
+    }
+}
+
+TEST_F(blend_test, identities) {
+    std::vector<pixel> dst(7, pixel{10, 20, 30, 40});
+    std::vector<pixel> clear(7, pixel{0, 0, 0, 0});
+    std::vector<pixel> opaque(7, pixel{1, 2, 3, 255});
+
+    criss_cross::source_over(dst, clear);
+    ASSERT_EQ(dst[6], (pixel{10, 20, 30, 40}));
+    criss_cross::multiply(dst, clear);
+    ASSERT_EQ(dst[5], (pixel{10, 20, 30, 40}));
+    criss_cross::erase(dst, clear);
+    ASSERT_EQ(dst[4], (pixel{10, 20, 30, 40}));
+
+    criss_cross::source_over(dst, opaque);
+    ASSERT_EQ(dst[0], (pixel{1, 2, 3, 255}));
+    criss_cross::erase(dst, opaque);
+    ASSERT_EQ(dst[1], (pixel{0, 0, 0, 0}));
+
+    std::vector<pixel> white(9, pixel{255, 255, 255, 255});
+    std::vector<pixel> gray(9, pixel{128, 64, 32, 255});
+    criss_cross::multiply(white, gray);
+    ASSERT_EQ(white[8], (pixel{128, 64, 32, 255}));
+}
+
+TEST_F(blend_test, bit_exact) {
+    RecordProperty("kernels", criss_cross::blend_kernels);
+    std::mt19937 gen{7};
+    for (size_t n : {0, 1, 3, 4, 5, 8, 15, 16, 17, 31, 33, 100}) {
+        auto src = random_pixels(n + 1, gen);
+        auto dst = random_pixels(n + 1, gen);
+        std::vector<uint8_t> mask(n + 1);
+        for (auto& m : mask) m = static_cast<uint8_t>(std::uniform_int_distribution<int>(0, 255)(gen));
+        // offset by one pixel so vector loads are unaligned
+        auto s = std::span<pixel const>{src}.subspan(1);
+        auto m = std::span<uint8_t const>{mask}.subspan(1);
+        auto bytes = [](auto const& v) { return reinterpret_cast<uint8_t const*>(v.data()) + 4; };
+
+        auto check = [&](auto kernel, auto reference) {
+            auto expected = dst;
+            auto actual = dst;
+            reference(reinterpret_cast<uint8_t*>(expected.data()) + 4, bytes(src), n);
+            kernel(std::span<pixel>{actual}.subspan(1), s);
+            ASSERT_EQ(0, std::memcmp(expected.data(), actual.data(), actual.size() * sizeof (pixel))) << n;
+        };
+        check([](auto d, auto s) { criss_cross::source_over(d, s); }, criss_cross::blend_scalar::source_over);
+        check([](auto d, auto s) { criss_cross::multiply(d, s); }, criss_cross::blend_scalar::multiply);
+        check([](auto d, auto s) { criss_cross::erase(d, s); }, criss_cross::blend_scalar::erase);
+
+        pixel color{40, 80, 120, 160};
+        auto expected = dst;
+        auto actual = dst;
+        criss_cross::blend_scalar::dab(reinterpret_cast<uint8_t*>(expected.data()) + 4, m.data(),
+                                       reinterpret_cast<uint8_t const*>(&color), n);
+        criss_cross::dab(std::span<pixel>{actual}.subspan(1), m, color);
+        ASSERT_EQ(0, std::memcmp(expected.data(), actual.data(), actual.size() * sizeof (pixel))) << n;
+    }
+}
+
+TEST_F(blend_test, stamp) {
+    std::vector<pixel> image(8 * 6, pixel{0, 0, 0, 0});
+    std::vector<uint8_t> mask(3 * 3, 255);
+    pixel color{0, 0, 255, 255};
+
+    criss_cross::stamp(image, 8, 8, mask, 3, -1, 4, color);
+    ASSERT_EQ(image[4 * 8 + 0], color);
+    ASSERT_EQ(image[4 * 8 + 1], color);
+    ASSERT_EQ(image[4 * 8 + 2], (pixel{0, 0, 0, 0}));
+    ASSERT_EQ(image[5 * 8 + 1], color);
+    ASSERT_EQ(image[3 * 8 + 0], (pixel{0, 0, 0, 0}));
+
+    criss_cross::stamp(image, 8, 8, mask, 3, 7, 0, color);
+    ASSERT_EQ(image[0 * 8 + 7], color);
+    ASSERT_EQ(image[1 * 8 + 0], (pixel{0, 0, 0, 0}));
+
+    criss_cross::stamp(image, 8, 8, mask, 3, 9, 0, color);
+    criss_cross::stamp(image, 8, 8, mask, 3, 0, -5, color);
+    ASSERT_EQ(std::count(image.begin(), image.end(), color), 7);
+
+    // an empty image, or one with no pixels to a row, takes no dab
+    criss_cross::stamp({}, 0, 0, mask, 3, 0, 0, color);
+    criss_cross::stamp(image, 0, 8, mask, 3, 0, 0, color);
+    criss_cross::stamp(image, 8, 0, mask, 3, 0, 0, color);
+    ASSERT_EQ(std::count(image.begin(), image.end(), color), 7);
+}
@@ -0,0 +1,291 @@
+#ifndef INCLUDE_BLEND_HPP
+#define INCLUDE_BLEND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <algorithm>
+
+#if !defined(CRISS_CROSS_BLEND_SCALAR) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
+#include <aux/versor.hpp>
+
+// Premultiplied RGBA8 compositing.  A pixel is versor<uint8_t, 4> with alpha
+// in channel 3; the colour channels may be in either RGB or BGR order (the
+// little-endian ARGB8888 words of a wl_buffer are B, G, R, A), since only
+// alpha is treated specially.  Inputs must be valid premultiplied pixels,
+// every colour channel <= alpha.
+//
+// Products are scaled back with div255, the exactly rounded x / 255, so the
+// kernels are bit-exact with the scalar definitions in blend_scalar.  The
+// vector paths handle 8 (AVX2) or 4 (SSE2) pixels per iteration and are
+// picked at compile time: AVX2 needs -mavx2 (the CRISS_CROSS_AVX2 CMake
+// option); define CRISS_CROSS_BLEND_SCALAR to force scalar.
+namespace criss_cross
+{
+    using pixel = aux::versor<uint8_t, 4>;
+    static_assert(sizeof (pixel) == 4);
+
+    // the kernels this build uses
+#if defined(CRISS_CROSS_BLEND_SCALAR) || !(defined(__AVX2__) || defined(__SSE2__))
+    constexpr char const* blend_kernels = "scalar";
+#elif defined(__AVX2__)
+    constexpr char const* blend_kernels = "avx2";
+#else
+    constexpr char const* blend_kernels = "sse2";
+#endif
+
+    // round(x / 255) for x <= 255 * 255
+    constexpr uint32_t div255(uint32_t x) noexcept {
+        return (x + 128 + ((x + 128) >> 8)) >> 8;
+    }
+
+    namespace blend_scalar
+    {
+        inline auto bytes(std::span<pixel> p) noexcept { return reinterpret_cast<uint8_t*>(p.data()); }
+        inline auto bytes(std::span<pixel const> p) noexcept { return reinterpret_cast<uint8_t const*>(p.data()); }
+
+        // d = s + d * (1 - sa)
+        inline void source_over(uint8_t* d, uint8_t const* s, size_t n) noexcept {
+            for (size_t i = 0; i < n * 4; i += 4) {
+                uint32_t k = 255 - s[i + 3];
+                for (size_t c = 0; c < 4; ++c) {
+                    d[i + c] = static_cast<uint8_t>(s[i + c] + div255(d[i + c] * k));
+                }
+            }
+        }
+        // d = s * d + s * (1 - da) + d * (1 - sa)
+        inline void multiply(uint8_t* d, uint8_t const* s, size_t n) noexcept {
+            for (size_t i = 0; i < n * 4; i += 4) {
+                uint32_t ks = 255 - s[i + 3];
+                uint32_t kd = 255 - d[i + 3];
+                for (size_t c = 0; c < 4; ++c) {
+                    d[i + c] = static_cast<uint8_t>(div255(s[i + c] * d[i + c] + s[i + c] * kd + d[i + c] * ks));
+                }
+            }
+        }
+        // d = d * (1 - sa)
+        inline void erase(uint8_t* d, uint8_t const* s, size_t n) noexcept {
+            for (size_t i = 0; i < n * 4; i += 4) {
+                uint32_t k = 255 - s[i + 3];
+                for (size_t c = 0; c < 4; ++c) {
+                    d[i + c] = static_cast<uint8_t>(div255(d[i + c] * k));
+                }
+            }
+        }
+        // d = (color * m) over d
+        inline void dab(uint8_t* d, uint8_t const* mask, uint8_t const* color, size_t n) noexcept {
+            for (size_t i = 0; i < n; ++i) {
+                uint8_t s[4];
+                for (size_t c = 0; c < 4; ++c) {
+                    s[c] = static_cast<uint8_t>(div255(color[c] * uint32_t{mask[i]}));
+                }
+                source_over(d + i * 4, s, 1);
+            }
+        }
+    } // ::blend_scalar
+
+#if !defined(CRISS_CROSS_BLEND_SCALAR) && (defined(__AVX2__) || defined(__SSE2__))
+#if defined(__GNUC__) && !defined(__clang__)
+    // GCC 12 flags the 32-byte loads of loop iterations it has itself proven
+    // dead when a kernel is inlined on a short fixed-size array.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+    namespace blend_simd
+    {
+#if defined(__AVX2__)
+        struct lanes {
+            using type = __m256i;
+            static constexpr size_t pixels = 8;
+            static type load(void const* p) noexcept { type v; std::memcpy(&v, p, sizeof (v)); return v; }
+            static void store(void* p, type v) noexcept { std::memcpy(p, &v, sizeof (v)); }
+            static type zero() noexcept { return _mm256_setzero_si256(); }
+            static type set16(short x) noexcept { return _mm256_set1_epi16(x); }
+            static type set32(int x) noexcept { return _mm256_set1_epi32(x); }
+            static type lo8(type a, type b) noexcept { return _mm256_unpacklo_epi8(a, b); }
+            static type hi8(type a, type b) noexcept { return _mm256_unpackhi_epi8(a, b); }
+            static type mul16(type a, type b) noexcept { return _mm256_mullo_epi16(a, b); }
+            static type add16(type a, type b) noexcept { return _mm256_add_epi16(a, b); }
+            static type srl16(type a) noexcept { return _mm256_srli_epi16(a, 8); }
+            static type pack16(type a, type b) noexcept { return _mm256_packus_epi16(a, b); }
+            static type adds8(type a, type b) noexcept { return _mm256_adds_epu8(a, b); }
+            static type bitxor(type a, type b) noexcept { return _mm256_xor_si256(a, b); }
+            static type srl32(type a) noexcept { return _mm256_srli_epi32(a, 24); }
+            static type mul32(type a, type b) noexcept { return _mm256_mullo_epi32(a, b); }
+            static type load_mask(uint8_t const* m) noexcept {
+                return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(m)));
+            }
+        };
+#else
+        struct lanes {
+            using type = __m128i;
+            static constexpr size_t pixels = 4;
+            static type load(void const* p) noexcept { return _mm_loadu_si128(static_cast<type const*>(p)); }
+            static void store(void* p, type v) noexcept { _mm_storeu_si128(static_cast<type*>(p), v); }
+            static type zero() noexcept { return _mm_setzero_si128(); }
+            static type set16(short x) noexcept { return _mm_set1_epi16(x); }
+            static type set32(int x) noexcept { return _mm_set1_epi32(x); }
+            static type lo8(type a, type b) noexcept { return _mm_unpacklo_epi8(a, b); }
+            static type hi8(type a, type b) noexcept { return _mm_unpackhi_epi8(a, b); }
+            static type mul16(type a, type b) noexcept { return _mm_mullo_epi16(a, b); }
+            static type add16(type a, type b) noexcept { return _mm_add_epi16(a, b); }
+            static type srl16(type a) noexcept { return _mm_srli_epi16(a, 8); }
+            static type pack16(type a, type b) noexcept { return _mm_packus_epi16(a, b); }
+            static type adds8(type a, type b) noexcept { return _mm_adds_epu8(a, b); }
+            static type bitxor(type a, type b) noexcept { return _mm_xor_si128(a, b); }
+            static type srl32(type a) noexcept { return _mm_srli_epi32(a, 24); }
+            // SSE2 has no 32-bit mullo; broadcasting a byte only needs shifts
+            static type mul32(type a, type) noexcept {
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+                return _mm_or_si128(a, _mm_slli_epi32(a, 16));
+            }
+            static type load_mask(uint8_t const* m) noexcept {
+                int32_t w;
+                std::memcpy(&w, m, sizeof (w));
+                auto v = _mm_cvtsi32_si128(w);
+                v = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+                return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+            }
+        };
+#endif
+        using V = lanes;
+        using vec = V::type;
+
+        // byte b of every pixel copied to all four bytes of that pixel
+        inline vec broadcast(vec v) noexcept { return V::mul32(v, V::set32(0x01010101)); }
+        inline vec alpha(vec v) noexcept { return broadcast(V::srl32(v)); }
+        inline vec div255(vec x) noexcept {
+            x = V::add16(x, V::set16(128));
+            return V::srl16(V::add16(x, V::srl16(x)));
+        }
+        // div255(a * b) per byte, in two 16-bit halves
+        inline vec scale(vec a, vec b) noexcept {
+            auto z = V::zero();
+            auto lo = div255(V::mul16(V::lo8(a, z), V::lo8(b, z)));
+            auto hi = div255(V::mul16(V::hi8(a, z), V::hi8(b, z)));
+            return V::pack16(lo, hi);
+        }
+        inline vec over(vec s, vec d) noexcept {
+            auto k = V::bitxor(alpha(s), V::set32(-1));
+            return V::adds8(s, scale(d, k));
+        }
+
+        inline size_t source_over(uint8_t* d, uint8_t const* s, size_t n) noexcept {
+            size_t i = 0;
+            for (size_t end = n / V::pixels * V::pixels; i < end; i += V::pixels) {
+                V::store(d + i * 4, over(V::load(s + i * 4), V::load(d + i * 4)));
+            }
+            return i;
+        }
+        inline size_t multiply(uint8_t* d, uint8_t const* s, size_t n) noexcept {
+            auto z = V::zero();
+            auto ones = V::set32(-1);
+            size_t i = 0;
+            for (size_t end = n / V::pixels * V::pixels; i < end; i += V::pixels) {
+                auto sv = V::load(s + i * 4);
+                auto dv = V::load(d + i * 4);
+                auto ks = V::bitxor(alpha(sv), ones);
+                auto kd = V::bitxor(alpha(dv), ones);
+                auto half = [&](auto unpack) noexcept {
+                    auto s16 = unpack(sv, z);
+                    auto d16 = unpack(dv, z);
+                    auto x = V::mul16(s16, d16);
+                    x = V::add16(x, V::mul16(s16, unpack(kd, z)));
+                    x = V::add16(x, V::mul16(d16, unpack(ks, z)));
+                    return div255(x);
+                };
+                V::store(d + i * 4, V::pack16(half([](vec a, vec b) noexcept { return V::lo8(a, b); }),
+                                              half([](vec a, vec b) noexcept { return V::hi8(a, b); })));
+            }
+            return i;
+        }
+        inline size_t erase(uint8_t* d, uint8_t const* s, size_t n) noexcept {
+            auto ones = V::set32(-1);
+            size_t i = 0;
+            for (size_t end = n / V::pixels * V::pixels; i < end; i += V::pixels) {
+                auto k = V::bitxor(alpha(V::load(s + i * 4)), ones);
+                V::store(d + i * 4, scale(V::load(d + i * 4), k));
+            }
+            return i;
+        }
+        inline size_t dab(uint8_t* d, uint8_t const* mask, uint8_t const* color, size_t n) noexcept {
+            int32_t c;
+            std::memcpy(&c, color, sizeof (c));
+            auto cv = V::set32(c);
+            size_t i = 0;
+            for (size_t end = n / V::pixels * V::pixels; i < end; i += V::pixels) {
+                auto m = broadcast(V::load_mask(mask + i));
+                V::store(d + i * 4, over(scale(cv, m), V::load(d + i * 4)));
+            }
+            return i;
+        }
+    } // ::blend_simd
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    // Span kernels; dst and src must have the same size.
+    inline void source_over(std::span<pixel> dst, std::span<pixel const> src) noexcept {
+        auto d = blend_scalar::bytes(dst);
+        auto s = blend_scalar::bytes(src);
+        size_t i = 0;
+#if !defined(CRISS_CROSS_BLEND_SCALAR) && (defined(__AVX2__) || defined(__SSE2__))
+        i = blend_simd::source_over(d, s, dst.size());
+#endif
+        blend_scalar::source_over(d + i * 4, s + i * 4, dst.size() - i);
+    }
+    inline void multiply(std::span<pixel> dst, std::span<pixel const> src) noexcept {
+        auto d = blend_scalar::bytes(dst);
+        auto s = blend_scalar::bytes(src);
+        size_t i = 0;
+#if !defined(CRISS_CROSS_BLEND_SCALAR) && (defined(__AVX2__) || defined(__SSE2__))
+        i = blend_simd::multiply(d, s, dst.size());
+#endif
+        blend_scalar::multiply(d + i * 4, s + i * 4, dst.size() - i);
+    }
+    inline void erase(std::span<pixel> dst, std::span<pixel const> src) noexcept {
+        auto d = blend_scalar::bytes(dst);
+        auto s = blend_scalar::bytes(src);
+        size_t i = 0;
+#if !defined(CRISS_CROSS_BLEND_SCALAR) && (defined(__AVX2__) || defined(__SSE2__))
+        i = blend_simd::erase(d, s, dst.size());
+#endif
+        blend_scalar::erase(d + i * 4, s + i * 4, dst.size() - i);
+    }
+    // One row of a brush dab: dst[i] = (color * mask[i]) over dst[i].
+    inline void dab(std::span<pixel> dst, std::span<uint8_t const> mask, pixel color) noexcept {
+        auto d = blend_scalar::bytes(dst);
+        auto c = reinterpret_cast<uint8_t const*>(&color);
+        size_t i = 0;
+#if !defined(CRISS_CROSS_BLEND_SCALAR) && (defined(__AVX2__) || defined(__SSE2__))
+        i = blend_simd::dab(d, mask.data(), c, dst.size());
+#endif
+        blend_scalar::dab(d + i * 4, mask.data() + i, c, dst.size() - i);
+    }
+
+    // Stamps a mask_width-wide coverage mask with its top-left corner at
+    // (x, y) into an image of rows lines of stride pixels, clipped to it.
+    inline void stamp(std::span<pixel> image, size_t stride, size_t width,
+                      std::span<uint8_t const> mask, size_t mask_width,
+                      int x, int y, pixel color) noexcept
+    {
+        if (mask_width == 0 || stride == 0 || width == 0) return;
+        auto rows = static_cast<long>(image.size() / stride);
+        auto mask_rows = static_cast<long>(mask.size() / mask_width);
+        long x0 = std::max<long>(x, 0), x1 = std::min<long>(x + static_cast<long>(mask_width), static_cast<long>(width));
+        long y0 = std::max<long>(y, 0), y1 = std::min<long>(y + mask_rows, rows);
+        if (x0 >= x1) return;
+        for (long row = y0; row < y1; ++row) {
+            auto m = mask.subspan(static_cast<size_t>(row - y) * mask_width + static_cast<size_t>(x0 - x),
+                                  static_cast<size_t>(x1 - x0));
+            dab(image.subspan(static_cast<size_t>(row) * stride + static_cast<size_t>(x0), m.size()), m, color);
+        }
+    }
+} // ::criss_cross
+
+#endif // INCLUDE_BLEND_HPP
@@ -0,0 +1,86 @@
+
+#include <gtest/gtest.h>
+
+#include "damage.hpp"
+
+class damage_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+using criss_cross::damage_rect;
+using criss_cross::damage_tracker;
+
+TEST_F(damage_test, tiles) {
+    damage_tracker damage{{200, 100}, 64};
+    ASSERT_EQ(damage.columns(), 4);
+    ASSERT_EQ(damage.rows(), 2);
+
+    // a fresh tracker damages everything, clipped to the surface
+    auto all = damage.frame_damage();
+    ASSERT_EQ(all.size(), 2);
+    ASSERT_EQ(all[0], (damage_rect{{0, 0}, {200, 64}}));
+    ASSERT_EQ(all[1], (damage_rect{{0, 64}, {200, 100}}));
+
+    damage.commit();
+    ASSERT_TRUE(damage.empty());
+    ASSERT_TRUE(damage.frame_damage().empty());
+
+    damage.add(damage_rect{{70, 10}, {130, 20}});
+    damage.add(damage_rect{{-10, 90}, {5, 500}});
+    damage.add(damage_rect{{300, 0}, {400, 10}});
+    auto d = damage.frame_damage();
+    ASSERT_EQ(d.size(), 2);
+    ASSERT_EQ(d[0], (damage_rect{{64, 0}, {192, 64}}));
+    ASSERT_EQ(d[1], (damage_rect{{0, 64}, {64, 100}}));
+}
+
+TEST_F(damage_test, segment) {
+    damage_tracker damage{{256, 256}, 32};
+    damage.commit();
+    damage.add(aux::versor<float, 2>{40.0f, 40.0f}, aux::versor<float, 2>{60.0f, 41.0f}, 2.0f);
+    auto d = damage.frame_damage();
+    ASSERT_EQ(d.size(), 1);
+    ASSERT_EQ(d[0], (damage_rect{{32, 32}, {64, 64}}));
+
+    damage.add(aux::versor<float, 2>{62.5f, 40.0f}, aux::versor<float, 2>{62.5f, 40.0f}, 1.0f);
+    d = damage.frame_damage();
+    ASSERT_EQ(d.size(), 1);
+    ASSERT_EQ(d[0], (damage_rect{{32, 32}, {96, 64}}));
+}
+
+TEST_F(damage_test, buffer_age) {
+    damage_tracker damage{{128, 128}, 32};
+    damage.commit();
+
+    damage.add(damage_rect{{0, 0}, {1, 1}});
+    damage.commit();
+    damage.add(damage_rect{{40, 0}, {41, 1}});
+    damage.commit();
+    damage.add(damage_rect{{100, 100}, {101, 101}});
+
+    // age 1: the buffer holds the previous frame
+    auto r1 = damage.repaint(1);
+    ASSERT_EQ(r1.size(), 1);
+    ASSERT_EQ(r1[0], (damage_rect{{96, 96}, {128, 128}}));
+
+    // age 2 and 3 pick up the frames that buffer has not seen
+    auto r2 = damage.repaint(2);
+    ASSERT_EQ(r2.size(), 2);
+    ASSERT_EQ(r2[0], (damage_rect{{32, 0}, {64, 32}}));
+    auto r3 = damage.repaint(3);
+    ASSERT_EQ(r3.size(), 2);
+    ASSERT_EQ(r3[0], (damage_rect{{0, 0}, {64, 32}}));
+
+    // undefined contents and ages beyond the history repaint everything
+    auto r0 = damage.repaint(0);
+    ASSERT_EQ(r0.size(), 4);
+    ASSERT_EQ(r0[0], (damage_rect{{0, 0}, {128, 32}}));
+    ASSERT_EQ(damage.repaint(damage_tracker::history_depth + 2).size(), 4);
+
+    // resize starts over
+    damage.resize({64, 32});
+    ASSERT_EQ(damage.repaint(1).size(), 1);
+    ASSERT_EQ(damage.repaint(1)[0], (damage_rect{{0, 0}, {64, 32}}));
+}
@@ -0,0 +1,179 @@
+#ifndef INCLUDE_DAMAGE_HPP
+#define INCLUDE_DAMAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <span>
+#include <algorithm>
+
+#include <aux/versor.hpp>
+
+namespace criss_cross
+{
+    // Half-open pixel rectangle [lo, hi) in buffer coordinates.
+    struct damage_rect {
+        aux::versor<int, 2> lo;
+        aux::versor<int, 2> hi;
+
+        constexpr bool empty() const noexcept {
+            return !(get<0>(lo) < get<0>(hi) && get<1>(lo) < get<1>(hi));
+        }
+        constexpr int width() const noexcept { return get<0>(hi) - get<0>(lo); }
+        constexpr int height() const noexcept { return get<1>(hi) - get<1>(lo); }
+        constexpr bool operator==(damage_rect const&) const noexcept = default;
+    };
+
+    // Dirty-tile bookkeeping for one surface.  Damage is recorded per tile
+    // for the frame being built; commit() moves it into a short history so a
+    // pooled back buffer of age n only repaints what changed during the last
+    // n frames instead of copying a whole frame from the front buffer.
+    class damage_tracker {
+    public:
+        constexpr static size_t history_depth = 4;
+
+    public:
+        explicit damage_tracker(aux::versor<int, 2> extent, int tile = 64)
+            : tile{tile}
+        {
+            resize(extent);
+        }
+
+    public:
+        aux::versor<int, 2> extent() const noexcept { return {width, height}; }
+        int tile_size() const noexcept { return tile; }
+        int columns() const noexcept { return tiles_x; }
+        int rows() const noexcept { return tiles_y; }
+
+        // Everything becomes undefined: the history is dropped and the whole
+        // surface is damaged.
+        void resize(aux::versor<int, 2> extent) {
+            width = std::max(get<0>(extent), 0);
+            height = std::max(get<1>(extent), 0);
+            tiles_x = (width + tile - 1) / tile;
+            tiles_y = (height + tile - 1) / tile;
+            words = (static_cast<size_t>(tiles_x) * tiles_y + 63) / 64;
+            current.assign(words, 0);
+            scratch.assign(words, 0);
+            for (auto& h : history) h.assign(words, 0);
+            history_head = 0;
+            history_count = 0;
+            rects.clear();
+            rects.reserve(static_cast<size_t>(tiles_x) * tiles_y);
+            add_all();
+        }
+
+        void add(damage_rect const& r) noexcept {
+            auto lo = aux::max(r.lo, aux::versor<int, 2>{0, 0});
+            auto hi = aux::min(r.hi, aux::versor<int, 2>{width, height});
+            if (damage_rect{lo, hi}.empty()) return;
+            int x0 = get<0>(lo) / tile, x1 = (get<0>(hi) - 1) / tile;
+            int y0 = get<1>(lo) / tile, y1 = (get<1>(hi) - 1) / tile;
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    set(current, static_cast<size_t>(y) * tiles_x + x);
+                }
+            }
+        }
+
+        // Damage of a stroke segment a-b drawn with the given radius; one
+        // extra pixel covers the antialiased fringe.
+        void add(aux::versor<float, 2> a, aux::versor<float, 2> b, float radius) noexcept {
+            auto r = radius + 1;
+            auto lo = aux::min(a, b);
+            auto hi = aux::max(a, b);
+            add(damage_rect{
+                    {static_cast<int>(std::floor(get<0>(lo) - r)), static_cast<int>(std::floor(get<1>(lo) - r))},
+                    {static_cast<int>(std::ceil(get<0>(hi) + r)) + 1, static_cast<int>(std::ceil(get<1>(hi) + r)) + 1},
+                });
+        }
+
+        void add_all() noexcept {
+            auto n = static_cast<size_t>(tiles_x) * tiles_y;
+            std::fill(current.begin(), current.end(), ~uint64_t{0});
+            if (n % 64) current.back() = (uint64_t{1} << (n % 64)) - 1;
+        }
+
+        bool empty() const noexcept {
+            return std::all_of(current.begin(), current.end(), [](auto w) { return w == 0; });
+        }
+
+        // Damage of the frame being built, as row runs of dirty tiles clipped
+        // to the surface; this is what wl_surface_damage_buffer is told.
+        std::span<damage_rect const> frame_damage() {
+            return to_rects(current);
+        }
+
+        // What a back buffer of the given age has to repaint: this frame's
+        // damage plus that of the age - 1 frames committed before it.  Age 0
+        // (undefined contents) or an age beyond the history repaints all.
+        std::span<damage_rect const> repaint(unsigned age) {
+            if (age == 0 || age - 1 > history_count) {
+                std::fill(scratch.begin(), scratch.end(), ~uint64_t{0});
+                auto n = static_cast<size_t>(tiles_x) * tiles_y;
+                if (n % 64) scratch.back() = (uint64_t{1} << (n % 64)) - 1;
+                return to_rects(scratch);
+            }
+            std::copy(current.begin(), current.end(), scratch.begin());
+            for (unsigned i = 1; i < age; ++i) {
+                auto const& h = history[(history_head + history_depth - i) % history_depth];
+                for (size_t w = 0; w < words; ++w) scratch[w] |= h[w];
+            }
+            return to_rects(scratch);
+        }
+
+        // The frame has been submitted: its damage becomes history.
+        void commit() noexcept {
+            std::swap(history[history_head], current);
+            history_head = (history_head + 1) % history_depth;
+            history_count = std::min(history_count + 1, history_depth);
+            std::fill(current.begin(), current.end(), 0);
+        }
+
+    private:
+        static void set(std::vector<uint64_t>& mask, size_t i) noexcept {
+            mask[i / 64] |= uint64_t{1} << (i % 64);
+        }
+        static bool test(std::vector<uint64_t> const& mask, size_t i) noexcept {
+            return (mask[i / 64] >> (i % 64)) & 1;
+        }
+
+        std::span<damage_rect const> to_rects(std::vector<uint64_t> const& mask) {
+            rects.clear();
+            for (int y = 0; y < tiles_y; ++y) {
+                auto row = static_cast<size_t>(y) * tiles_x;
+                for (int x = 0; x < tiles_x; ) {
+                    if (!test(mask, row + x)) {
+                        ++x;
+                        continue;
+                    }
+                    int x0 = x;
+                    while (x < tiles_x && test(mask, row + x)) ++x;
+                    rects.push_back(damage_rect{
+                            {x0 * tile, y * tile},
+                            {std::min(x * tile, width), std::min((y + 1) * tile, height)},
+                        });
+                }
+            }
+            return rects;
+        }
+
+    private:
+        int tile;
+        int width = 0;
+        int height = 0;
+        int tiles_x = 0;
+        int tiles_y = 0;
+        size_t words = 0;
+        std::vector<uint64_t> current;
+        std::vector<uint64_t> scratch;
+        std::array<std::vector<uint64_t>, history_depth> history;
+        size_t history_head = 0;
+        size_t history_count = 0;
+        std::vector<damage_rect> rects;   // reserved for every tile, reused
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_DAMAGE_HPP
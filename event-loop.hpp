@@ -0,0 +1,239 @@
+#ifndef INCLUDE_EVENT_LOOP_HPP
+#define INCLUDE_EVENT_LOOP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stop_token>
+#include <system_error>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <wayland-client.h>
+
+#include "trace.hpp"
+
+namespace criss_cross
+{
+    // Counters of one reading thread.  The histogram is owned by that
+    // thread; read it once the thread is done (after event_loop::stop()
+    // for the input thread).
+    struct event_loop_stats {
+        std::atomic<size_t> wakeups = 0;      // epoll_wait returns
+        std::atomic<size_t> dispatched = 0;   // events handed to listeners
+        latency_histogram dispatch;           // wakeup -> listeners done
+    };
+
+    // Reads the display from two threads with wl_display_prepare_read and
+    // epoll.  Objects on input_queue() (the tablet seat and its tools) are
+    // dispatched on a thread of their own, so pen samples are decoded while
+    // the main thread renders; everything else, frame callbacks included,
+    // stays on the default queue and is dispatched by wait() on the caller's
+    // thread.  Neither thread ever polls: both sleep in epoll_wait until the
+    // display fd is readable, wake() is called or the loop stops.
+    //
+    // A thread holds a prepared read only while it sleeps, so one thread
+    // busy rendering never holds up the other's reads.
+    class event_loop {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    public:
+        explicit event_loop(wl_display* display)
+            : display{display}
+            , queue{wl_display_create_queue(display)}
+            , main_epoll{make_epoll()}
+            , input_epoll{make_epoll()}
+            , wake_fd{make_eventfd()}
+            , stop_fd{make_eventfd()}
+        {
+            watch(main_epoll, wl_display_get_fd(display), EPOLLIN);
+            watch(main_epoll, wake_fd, EPOLLIN);
+            watch(input_epoll, wl_display_get_fd(display), EPOLLIN);
+            watch(input_epoll, stop_fd, EPOLLIN);
+        }
+        event_loop(event_loop const&) = delete;
+        event_loop& operator=(event_loop const&) = delete;
+
+        // Objects still on input_queue() must be gone by now.
+        ~event_loop() {
+            stop();
+            wl_event_queue_destroy(queue);
+            ::close(stop_fd);
+            ::close(wake_fd);
+            ::close(input_epoll);
+            ::close(main_epoll);
+        }
+
+    public:
+        wl_event_queue* input_queue() const noexcept { return queue; }
+
+        // Starts dispatching input_queue().  Call it once the listeners of
+        // the objects created on it are in place, so none of their first
+        // events goes unheard.
+        void start() {
+            if (input.joinable()) return;
+            input = std::jthread{[this](std::stop_token stop) { read_input(stop); }};
+        }
+
+        // Stops and joins the input thread; input_queue() is not dispatched
+        // afterwards.  start() may be called again.
+        void stop() {
+            if (!input.joinable()) return;
+            input.request_stop();
+            signal(stop_fd);
+            input.join();
+            drain(stop_fd);
+        }
+
+        // Makes the current or next wait() return; callable from any thread.
+        void wake() noexcept {
+            signal(wake_fd);
+        }
+
+        // Flushes requests, then sleeps until there are events for the
+        // default queue or wake() is called, and dispatches them.  Returns
+        // false when the connection is lost.
+        bool wait() {
+            if (wl_display_prepare_read(display) != 0) {
+                // already queued (by the input thread's reads, say)
+                return dispatch(clock::now());
+            }
+            if (!flush(main_epoll, main_out)) {
+                wl_display_cancel_read(display);
+                return false;
+            }
+            epoll_event events[2];
+            int n;
+            do {
+                n = ::epoll_wait(main_epoll, events, 2, -1);
+            } while (n < 0 && errno == EINTR);
+            auto woken = clock::now();
+            main_stats.wakeups.fetch_add(1, std::memory_order_relaxed);
+            bool readable = false;
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.fd == wake_fd) {
+                    drain(wake_fd);
+                }
+                else if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                    readable = true;
+                }
+            }
+            if (readable) {
+                if (wl_display_read_events(display) == -1) return false;
+            }
+            else {
+                wl_display_cancel_read(display);
+            }
+            return dispatch(woken);
+        }
+
+    public:
+        event_loop_stats const& main_thread() const noexcept { return main_stats; }
+        event_loop_stats const& input_thread() const noexcept { return input_stats; }
+
+    private:
+        bool dispatch(clock::time_point woken) {
+            CRISS_CROSS_TRACE_SCOPE("loop.dispatch");
+            auto n = wl_display_dispatch_pending(display);
+            if (n < 0) return false;
+            main_stats.dispatched.fetch_add(static_cast<size_t>(n), std::memory_order_relaxed);
+            main_stats.dispatch.record(clock::now() - woken);
+            return true;
+        }
+
+        void read_input(std::stop_token stop) {
+            CRISS_CROSS_TRACE_THREAD("input");
+            auto fd = wl_display_get_fd(display);
+            epoll_event events[2];
+            while (!stop.stop_requested()) {
+                auto woken = clock::now();
+                if (wl_display_prepare_read_queue(display, queue) == 0) {
+                    if (!flush(input_epoll, input_out)) {
+                        wl_display_cancel_read(display);
+                        break;
+                    }
+                    auto n = ::epoll_wait(input_epoll, events, 2, -1);
+                    woken = clock::now();
+                    input_stats.wakeups.fetch_add(1, std::memory_order_relaxed);
+                    bool readable = false;
+                    for (int i = 0; i < n; ++i) {
+                        if (events[i].data.fd == fd && (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))) readable = true;
+                    }
+                    if (!readable || stop.stop_requested()) {
+                        wl_display_cancel_read(display);
+                        continue;
+                    }
+                    if (wl_display_read_events(display) == -1) break;
+                }
+                CRISS_CROSS_TRACE_SCOPE("input.dispatch");
+                auto n = wl_display_dispatch_queue_pending(display, queue);
+                if (n < 0) break;
+                input_stats.dispatched.fetch_add(static_cast<size_t>(n), std::memory_order_relaxed);
+                input_stats.dispatch.record(clock::now() - woken);
+            }
+        }
+
+        // Sends what is buffered; while the socket is full, epoll also
+        // waits for it to drain (out tracks that, per epoll set).
+        bool flush(int epoll, bool& out) {
+            bool full = false;
+            if (wl_display_flush(display) == -1) {
+                if (errno != EAGAIN) return false;
+                full = true;
+            }
+            if (full != out) {
+                watch(epoll, wl_display_get_fd(display), full ? EPOLLIN | EPOLLOUT : EPOLLIN, EPOLL_CTL_MOD);
+                out = full;
+            }
+            return true;
+        }
+
+        static int make_epoll() {
+            auto fd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (fd < 0) throw std::system_error{errno, std::system_category(), "epoll_create1"};
+            return fd;
+        }
+        static int make_eventfd() {
+            auto fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (fd < 0) throw std::system_error{errno, std::system_category(), "eventfd"};
+            return fd;
+        }
+        static void watch(int epoll, int fd, uint32_t mask, int op = EPOLL_CTL_ADD) {
+            epoll_event e{};
+            e.events = mask;
+            e.data.fd = fd;
+            if (::epoll_ctl(epoll, op, fd, &e) < 0) {
+                throw std::system_error{errno, std::system_category(), "epoll_ctl"};
+            }
+        }
+        static void signal(int fd) noexcept {
+            uint64_t one = 1;
+            [[maybe_unused]] auto n = ::write(fd, &one, sizeof one);
+        }
+        static void drain(int fd) noexcept {
+            uint64_t count;
+            [[maybe_unused]] auto n = ::read(fd, &count, sizeof count);
+        }
+
+    private:
+        wl_display* display;
+        wl_event_queue* queue;
+        int main_epoll;
+        int input_epoll;
+        int wake_fd;
+        int stop_fd;
+        bool main_out = false;
+        bool input_out = false;
+        event_loop_stats main_stats;
+        event_loop_stats input_stats;
+        std::jthread input;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_EVENT_LOOP_HPP
@@ -0,0 +1,115 @@
+#ifndef INCLUDE_INK_HPP
+#define INCLUDE_INK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <mutex>
+#include <vector>
+#include <optional>
+#include <functional>
+
+#include "tablet-sample.hpp"
+#include "stroke-filter.hpp"
+#include "raster.hpp"
+#include "trace.hpp"
+
+namespace criss_cross
+{
+    // Pen-down samples smoothed and resampled into stroke pieces on the
+    // tablet processing thread, picked up by the render loop.  A piece
+    // continuing a stroke from an earlier batch starts with that batch's
+    // last vertex.
+    struct ink_queue {
+        std::mutex mutex;
+        std::vector<stroke_vertex> vertices;
+        std::vector<size_t> starts;
+        std::optional<int64_t> oldest;   // input time of the oldest sample, ns
+        size_t strokes = 0;
+    };
+
+    // Tablet timestamps are CLOCK_MONOTONIC milliseconds, the steady
+    // clock's base; widen one to nanoseconds against the current time.
+    inline int64_t input_time(uint32_t ms) {
+        auto now = trace::now() / 1'000'000;
+        auto age = static_cast<uint32_t>(static_cast<uint32_t>(now) - ms);
+        return (now - age) * 1'000'000;
+    }
+
+    // Batch handler turning the samples of one tool into ink: pen-down
+    // runs go through a stroke_filter (x, y, pressure) and come out as
+    // vertices whose radius scales with pressure.  wake is called on the
+    // first ink since the render loop's last pick-up.
+    class ink_processor {
+    public:
+        using pen_filter = stroke_filter<3>;
+
+    public:
+        ink_processor(ink_queue& ink, float radius, std::function<void()> wake = {})
+            : ink{&ink}
+            , radius{radius}
+            , wake{std::move(wake)}
+        {
+        }
+
+    public:
+        void operator()(std::span<tablet_sample const> batch) {
+            std::lock_guard lock{ink->mutex};
+            // the render loop sleeps until the first ink since its last
+            // pick-up; later batches wait for the next frame
+            bool idle = ink->vertices.empty();
+            // a stroke still down from the last batch continues in a new
+            // piece starting at its last vertex, once it has more
+            bool resume = down;
+            auto flush = [&] {
+                filter.push(raw, times, smooth);
+                raw.clear();
+                times.clear();
+                if (resume && !smooth.empty()) {
+                    ink->starts.push_back(ink->vertices.size());
+                    ink->vertices.push_back(last);
+                    resume = false;
+                }
+                for (auto const& p : smooth) {
+                    last = {{get<0>(p), get<1>(p)}, radius * get<2>(p)};
+                    ink->vertices.push_back(last);
+                }
+                smooth.clear();
+            };
+            for (auto const& s : batch) {
+                bool d = get<sample_state>(s) & tablet_down;
+                if (d && !down) {
+                    ink->starts.push_back(ink->vertices.size());
+                    ++ink->strokes;
+                }
+                if (d) {
+                    raw.push_back({get<sample_x>(s), get<sample_y>(s), get<sample_pressure>(s)});
+                    times.push_back(get<sample_time>(s));
+                    if (!ink->oldest) ink->oldest = input_time(get<sample_time>(s));
+                }
+                else if (down) {
+                    flush();
+                    filter.finish(smooth);
+                    flush();
+                    resume = false;
+                }
+                down = d;
+            }
+            flush();
+            if (idle && !ink->vertices.empty() && wake) wake();
+        }
+
+    private:
+        ink_queue* ink;
+        float radius;
+        std::function<void()> wake;
+        bool down = false;
+        pen_filter filter;
+        std::vector<pen_filter::sample> raw;
+        std::vector<uint32_t> times;
+        std::vector<pen_filter::sample> smooth;
+        stroke_vertex last{};
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_INK_HPP
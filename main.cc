@@ -1,7 +1,562 @@
 
 #include <iostream>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <mutex>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <cstdio>
+#include <iomanip>
+#include <memory_resource>
+#include <algorithm>
 
-int main() {
-    std::cout << "Hi." << std::endl;
-    return 0;
+#include <wayland-client.h>
+#include <xdg-shell-client.h>
+#include <zwp-tablet-v2-client.h>
+#include <zwp-linux-dmabuf-v1-client.h>
+
+#include <aux/arena.hpp>
+
+#include "tablet.hpp"
+#include "window.hpp"
+#include "presentation.hpp"
+#include "event-loop.hpp"
+#include "damage.hpp"
+#include "raster.hpp"
+#include "trace.hpp"
+#include "ink.hpp"
+#include "replay.hpp"
+
+#if !defined(NDEBUG)
+// debug builds count operator new calls, to show the drawing loop is off
+// the heap once warm
+AUX_COUNT_HEAP_ALLOCATIONS()
+#endif
+
+namespace
+{
+    struct globals {
+        wl_compositor* compositor = nullptr;
+        wl_shm* shm = nullptr;
+        xdg_wm_base* wm_base = nullptr;
+        zwp_linux_dmabuf_v1* dmabuf = nullptr;
+        wl_seat* seat = nullptr;
+        zwp_tablet_manager_v2* tablet_manager = nullptr;
+    };
+
+    template <class T>
+    void bind(T*& dst, wl_registry* registry, uint32_t name, wl_interface const& iface, uint32_t version) {
+        if (!dst) {
+            dst = static_cast<T*>(wl_registry_bind(registry, name, &iface, version));
+        }
+    }
+
+    void global(void* data, wl_registry* registry, uint32_t name, char const* interface, uint32_t version) {
+        auto g = static_cast<globals*>(data);
+        auto is = [interface](wl_interface const& iface) { return std::strcmp(interface, iface.name) == 0; };
+        if (is(wl_compositor_interface) && version >= 4) {
+            bind(g->compositor, registry, name, wl_compositor_interface, 4);
+        }
+        else if (is(wl_shm_interface)) {
+            bind(g->shm, registry, name, wl_shm_interface, 1);
+        }
+        else if (is(xdg_wm_base_interface)) {
+            bind(g->wm_base, registry, name, xdg_wm_base_interface, 1);
+        }
+        else if (is(zwp_linux_dmabuf_v1_interface) && version >= 3) {
+            bind(g->dmabuf, registry, name, zwp_linux_dmabuf_v1_interface, 3);
+        }
+        else if (is(wl_seat_interface)) {
+            bind(g->seat, registry, name, wl_seat_interface, 1);
+        }
+        else if (is(zwp_tablet_manager_v2_interface)) {
+            bind(g->tablet_manager, registry, name, zwp_tablet_manager_v2_interface, 1);
+        }
+    }
+    void global_remove(void*, wl_registry*, uint32_t) {
+    }
+    constexpr wl_registry_listener registry_listener = {
+        .global = global,
+        .global_remove = global_remove,
+    };
+
+    double ms(std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    // Copies r, clipped to both, from src to dst.
+    void blit(criss_cross::canvas_view dst, criss_cross::canvas_view src, criss_cross::damage_rect r) {
+        r.lo = aux::max(r.lo, aux::versor<int, 2>{0, 0});
+        r.hi = aux::min(r.hi, aux::versor<int, 2>{std::min(dst.width, src.width), std::min(dst.height, src.height)});
+        if (r.empty()) return;
+        for (int y = get<1>(r.lo); y < get<1>(r.hi); ++y) {
+            std::copy_n(src.row(y) + get<0>(r.lo), r.width(), dst.row(y) + get<0>(r.lo));
+        }
+    }
+
+    constexpr uint32_t paper = 0xfff4f1eau;
+    constexpr uint32_t ink_color = 0xff202020u;
+    constexpr float pen_radius = 4.0f;
+    constexpr size_t heap_warm_up = 30;   // frames before the loop should stop allocating
+
+    // The layer strokes accumulate in and its way to the screen: ink picked
+    // up from the queue is rasterized into the layer, and the damaged part
+    // of the layer copied into the next presented buffer.  Presents to a
+    // presentation or, in a --fake replay, a fake_presentation.
+    struct drawing {
+        drawing(int width, int height)
+            : damage{{width, height}}
+            , layer{width, height, paper}
+            , raster{pool}
+        {
+        }
+
+        // Follows a new surface size, keeping what is drawn; true when it
+        // changed.
+        bool fit(int width, int height) {
+            if (damage.extent() == aux::versor<int, 2>{width, height}) return false;
+            damage.resize({width, height});
+            criss_cross::memory_canvas resized{width, height, paper};
+            blit(resized.view(), layer.view(), {{0, 0}, {layer.width(), layer.height()}});
+            layer = std::move(resized);
+            return true;
+        }
+
+        // Draws everything in the queue into the layer.
+        void draw(criss_cross::ink_queue& ink) {
+            {
+                std::lock_guard lock{ink.mutex};
+                std::swap(vertices, ink.vertices);
+                std::swap(starts, ink.starts);
+                if (ink.oldest && !uncommitted) uncommitted = ink.oldest;
+                ink.oldest.reset();
+            }
+            CRISS_CROSS_TRACE_INSTANT("ink.handoff", vertices.size());
+            {
+                std::pmr::vector<criss_cross::stroke> pieces{&frame_memory};
+                pieces.reserve(starts.size());
+                for (size_t i = 0; i < starts.size(); ++i) {
+                    auto end = i + 1 < starts.size() ? starts[i + 1] : vertices.size();
+                    pieces.push_back({std::span{vertices}.subspan(starts[i], end - starts[i]), ink_color});
+                }
+                raster.draw(layer.view(), pieces);
+                criss_cross::rasterizer::damage(damage, pieces);
+            }
+            vertices.clear();
+            starts.clear();
+            // everything drawn is in the layer
+            frame_memory.reset();
+        }
+
+        // Copies the damage into an idle buffer of present and submits it;
+        // false when there is nothing to show or no buffer free.
+        template <class Presentation>
+        bool show(Presentation& present) {
+            if (present.frame_pending() || damage.empty()) return false;
+            auto b = present.acquire();
+            if (!b) return false;
+            criss_cross::canvas_view target{b->pixels, b->width, b->height, b->stride / 4};
+            for (auto const& r : damage.repaint(b->age)) {
+                blit(target, layer.view(), r);
+            }
+            present.submit(*b, damage.frame_damage());
+            damage.commit();
+            if (uncommitted) {
+                input_to_commit.record(std::chrono::nanoseconds{criss_cross::trace::now() - *uncommitted});
+                uncommitted.reset();
+            }
+            return true;
+        }
+
+        criss_cross::damage_tracker damage;
+        criss_cross::memory_canvas layer;
+        aux::thread_pool pool;
+        criss_cross::rasterizer raster;
+        std::vector<criss_cross::stroke_vertex> vertices;
+        std::vector<size_t> starts;
+        aux::frame_arena frame_memory;        // transient per-draw data
+        std::optional<int64_t> uncommitted;   // oldest input drawn but not yet committed
+        criss_cross::latency_histogram input_to_commit;
+    };
+
+    // Plays a recording through the ink processor into a drawing.  Every
+    // frame of the recording is drawn on its own, so the layer comes out
+    // the same bits however frames are paced or grouped for presentation.
+    // At the recorded pace a frame's samples count as input at the end of
+    // its period; at max speed, when they are handed over.
+    class replayer {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    public:
+        replayer(char const* path, bool max_speed)
+            : recording{path}
+            , source{recording.records()}
+            , max_speed{max_speed}
+        {
+        }
+
+    public:
+        bool done() const noexcept { return source.done(); }
+        bool fast() const noexcept { return max_speed; }
+        size_t samples() const noexcept { return source.size(); }
+        size_t frames() const noexcept { return source.frame(); }
+
+        void start() { began = clock::now(); }
+        // wall time the next frame is due at the recorded pace
+        clock::time_point due() const noexcept { return began + source.due(); }
+
+        // Draws the frames due by now, or at max speed the next one with
+        // samples; returns whether anything was drawn.
+        bool play(drawing& d, criss_cross::ink_queue& ink, criss_cross::ink_processor& process) {
+            CRISS_CROSS_TRACE_SCOPE("replay.play");
+            auto now = clock::now();
+            bool drawn = false;
+            while (!source.done() && (max_speed ? !drawn : due() <= now)) {
+                auto arrival = max_speed ? now : due();
+                auto batch = source.next();
+                if (batch.empty()) continue;
+                process(batch);
+                {
+                    std::lock_guard lock{ink.mutex};
+                    if (ink.oldest) ink.oldest = std::chrono::duration_cast<std::chrono::nanoseconds>(arrival.time_since_epoch()).count();
+                }
+                d.draw(ink);
+                drawn = true;
+            }
+            return drawn;
+        }
+
+    private:
+        criss_cross::tablet_recording recording;
+        criss_cross::replay_source source;
+        bool max_speed;
+        clock::time_point began;
+    };
+
+    struct options {
+        size_t frame_limit = 0;
+        char const* trace_file = nullptr;
+        char const* record_file = nullptr;
+        char const* replay_file = nullptr;
+        bool max_speed = false;
+        bool fake = false;
+        int width = 1920;     // of a --fake replay
+        int height = 1080;
+    };
+
+    // Lines common to every run: input-to-commit latency and, for a
+    // replay, its result and throughput.  The "replay:" line depends on
+    // the recording alone and serves as a regression check.
+    void report(drawing& d, criss_cross::ink_queue& ink, replayer const* replay, double seconds) {
+        std::cout << "input-to-commit ms: p50 " << ms(d.input_to_commit.percentile(0.5))
+                  << " p99 " << ms(d.input_to_commit.percentile(0.99))
+                  << " samples " << d.input_to_commit.size()
+                  << std::endl;
+        if (!replay) return;
+        std::lock_guard lock{ink.mutex};
+        std::cout << "replay: samples " << replay->samples()
+                  << " frames " << replay->frames()
+                  << " strokes " << ink.strokes
+                  << " checksum " << std::hex << std::setw(16) << std::setfill('0') << criss_cross::checksum(d.layer.view())
+                  << std::dec << std::setfill(' ') << '\n'
+                  << "replay/s: samples " << (seconds > 0 ? static_cast<double>(replay->samples()) / seconds : 0.0)
+                  << " seconds " << seconds
+                  << " peak rss MiB " << static_cast<double>(criss_cross::peak_rss()) / (1 << 20)
+                  << std::endl;
+    }
+
+    // --replay --fake: the whole drawing path without a compositor.
+    int replay_fake(options const& opts) {
+        CRISS_CROSS_TRACE_THREAD("main");
+        replayer replay{opts.replay_file, opts.max_speed};
+        criss_cross::fake_presentation present{opts.width, opts.height};
+        drawing d{opts.width, opts.height};
+        criss_cross::ink_queue ink;
+        criss_cross::ink_processor process{ink, pen_radius};
+        auto began = std::chrono::steady_clock::now();
+        replay.start();
+        while (!replay.done()) {
+            if (!replay.fast()) std::this_thread::sleep_until(replay.due());
+            if (replay.play(d, ink, process)) d.show(present);
+            if (opts.trace_file) criss_cross::trace::collect();
+        }
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+        auto const& s = present.stats();
+        std::cout << "frames: " << s.frames
+                  << " frames/s: " << (seconds > 0 ? static_cast<double>(s.frames) / seconds : 0.0)
+                  << " starved: " << s.starved
+                  << " damaged pixels: " << s.damaged_pixels << '\n'
+                  << "render ms: max " << ms(s.render_max)
+                  << " mean " << (s.frames ? ms(s.render_total) / s.frames : 0.0)
+                  << std::endl;
+        report(d, ink, &replay, seconds);
+        return 0;
+    }
+
+    // A session on the compositor: tablet input, or a replay, drawn into a
+    // window.
+    int run(options const& opts) {
+        CRISS_CROSS_TRACE_THREAD("main");
+
+        auto display = wl_display_connect(nullptr);
+        if (!display) {
+            std::cerr << "wl_display_connect failed" << std::endl;
+            return 1;
+        }
+        globals g;
+        auto registry = wl_display_get_registry(display);
+        wl_registry_add_listener(registry, &registry_listener, &g);
+        wl_display_roundtrip(display);
+        if (!g.compositor || !g.shm || !g.wm_base) {
+            std::cerr << "wl_compositor v4, wl_shm or xdg_wm_base not available" << std::endl;
+            wl_display_disconnect(display);
+            return 1;
+        }
+
+        std::optional<replayer> replay;
+        if (opts.replay_file) replay.emplace(opts.replay_file, opts.max_speed);
+        std::optional<criss_cross::tablet_recorder> recorder;
+        if (opts.record_file) recorder.emplace(opts.record_file);
+
+        // the input thread reads while this one renders; declared before the
+        // tablet, whose objects live on its input queue
+        criss_cross::event_loop loop{display};
+        auto began = std::chrono::steady_clock::now();
+        criss_cross::ink_queue ink;
+        criss_cross::ink_processor process{ink, pen_radius};
+        std::unique_ptr<criss_cross::tablet_input> tablet;
+        if (g.seat && g.tablet_manager && !replay) {
+            tablet = std::make_unique<criss_cross::tablet_input>(
+                g.tablet_manager, g.seat,
+                [&recorder, process = criss_cross::ink_processor{ink, pen_radius, [&loop] { loop.wake(); }}]
+                (std::span<criss_cross::tablet_sample const> batch) mutable {
+                    if (recorder) recorder->append(batch);
+                    process(batch);
+                },
+                loop.input_queue());
+            loop.start();
+        }
+
+        int status = 0;
+        {
+            criss_cross::window win{g.compositor, g.wm_base, "criss-cross"};
+            while (!win.configured() && loop.wait()) {
+                continue;
+            }
+            criss_cross::presentation present{display, win.get_surface(), g.shm, g.dmabuf, win.width(), win.height()};
+            drawing d{win.width(), win.height()};
+            std::optional<size_t> heap_mark;      // heap allocations when warm
+
+            // With --frames a synthetic pen stroke grows by one segment per
+            // frame, so every frame carries a little damage as a pen would.
+            auto synthetic = [&](size_t i) {
+                auto t = static_cast<float>(i);
+                auto span = static_cast<float>(std::max(win.width() - 40, 1));
+                return criss_cross::stroke_vertex{
+                    {20.0f + std::fmod(t * 3.0f, span), win.height() * 0.5f + 60.0f * std::sin(t * 0.1f)},
+                    2.0f + 2.0f * std::abs(std::sin(t * 0.05f)),
+                };
+            };
+
+            // At the recorded pace a replay wakes the loop once a frame
+            // period, as a pen would with samples.
+            std::jthread pacer;
+            if (replay) {
+                replay->start();
+                if (!replay->fast()) {
+                    pacer = std::jthread{[&](std::stop_token stop) {
+                        auto period = std::chrono::nanoseconds{1'000'000'000 / 60};
+                        for (auto next = std::chrono::steady_clock::now() + period; !stop.stop_requested(); next += period) {
+                            std::this_thread::sleep_until(next);
+                            loop.wake();
+                        }
+                    }};
+                }
+            }
+
+            for (;;) {
+                auto frame = present.stats().frames;
+                bool finished = replay && replay->done() && d.damage.empty() && !present.frame_pending();
+                if (win.closed() || finished || (opts.frame_limit && frame >= opts.frame_limit)) {
+                    break;
+                }
+                if (frame == heap_warm_up && !heap_mark) {
+                    heap_mark = aux::heap_allocations();
+                }
+                if (d.fit(win.width(), win.height())) {
+                    present.resize(win.width(), win.height());
+                }
+                if (!present.frame_pending()) {
+                    if (replay) {
+                        replay->play(d, ink, process);
+                    }
+                    else {
+                        if (opts.frame_limit) {
+                            std::lock_guard lock{ink.mutex};
+                            if (!ink.oldest) ink.oldest = criss_cross::trace::now();
+                            ink.starts.push_back(ink.vertices.size());
+                            ink.vertices.push_back(synthetic(frame));
+                            ink.vertices.push_back(synthetic(frame + 1));
+                        }
+                        d.draw(ink);
+                    }
+                }
+                d.show(present);
+                if (opts.trace_file) {
+                    criss_cross::trace::collect();
+                }
+                // at max speed a replay goes on as soon as a frame can be drawn
+                if (replay && replay->fast() && !present.frame_pending()) {
+                    loop.wake();
+                }
+                if (!loop.wait()) {
+                    status = 1;
+                    break;
+                }
+            }
+            pacer = {};
+
+            auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+            auto const& s = present.stats();
+            std::cout << "frames: " << s.frames
+                      << " frames/s: " << (seconds > 0 ? static_cast<double>(s.frames) / seconds : 0.0)
+                      << " dmabuf: " << s.dmabuf_allocations
+                      << " shm: " << s.shm_allocations
+                      << " dmabuf-failures: " << s.dmabuf_failures
+                      << " starved: " << s.starved << '\n'
+                      << "render ms: last " << ms(s.render_last)
+                      << " max " << ms(s.render_max)
+                      << " mean " << (s.frames ? ms(s.render_total) / s.frames : 0.0) << '\n'
+                      << "latency ms: last " << ms(s.latency_last)
+                      << " max " << ms(s.latency_max)
+                      << " mean " << (s.latency_samples ? ms(s.latency_total) / s.latency_samples : 0.0)
+                      << std::endl;
+            report(d, ink, replay ? &*replay : nullptr, seconds);
+            if (aux::heap_counting() && heap_mark) {
+                // resizes and --trace collection allocate; steady drawing does not
+                std::cout << "heap allocations after frame " << heap_warm_up << ": "
+                          << aux::heap_allocations() - *heap_mark
+                          << " frame arena: " << d.frame_memory.high_water() << " bytes"
+                          << std::endl;
+            }
+        }
+
+        loop.stop();
+        {
+            auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+            auto rate = [seconds](auto const& count) { return seconds > 0 ? static_cast<double>(count.load()) / seconds : 0.0; };
+            auto const& m = loop.main_thread();
+            auto const& in = loop.input_thread();
+            std::cout << "wakeups/s: main " << rate(m.wakeups)
+                      << " input " << rate(in.wakeups)
+                      << " events: main " << m.dispatched
+                      << " input " << in.dispatched << '\n'
+                      << "dispatch ms: main p50 " << ms(m.dispatch.percentile(0.5))
+                      << " p99 " << ms(m.dispatch.percentile(0.99))
+                      << " input p50 " << ms(in.dispatch.percentile(0.5))
+                      << " p99 " << ms(in.dispatch.percentile(0.99))
+                      << std::endl;
+        }
+        if (tablet) {
+            std::cout << "samples: " << tablet->pushed()
+                      << " processed: " << tablet->processed()
+                      << " dropped: " << tablet->dropped()
+                      << " high-water: " << tablet->high_water()
+                      << " strokes: " << [&ink] { std::lock_guard lock{ink.mutex}; return ink.strokes; }()
+                      << std::endl;
+            tablet.reset();
+        }
+        if (recorder) {
+            recorder->flush();
+            std::cout << "recorded: " << recorder->size() << " samples to " << opts.record_file << std::endl;
+        }
+        if (g.tablet_manager) zwp_tablet_manager_v2_destroy(g.tablet_manager);
+        if (g.seat) wl_seat_destroy(g.seat);
+        if (g.dmabuf) zwp_linux_dmabuf_v1_destroy(g.dmabuf);
+        xdg_wm_base_destroy(g.wm_base);
+        wl_shm_destroy(g.shm);
+        wl_compositor_destroy(g.compositor);
+        wl_registry_destroy(registry);
+        wl_display_disconnect(display);
+        return status;
+    }
+} // namespace
+
+// usage: criss-cross [--frames N] [--trace FILE] [--record FILE]
+//                    [--replay FILE [--speed recorded|max] [--fake [--size WxH]]]
+//   --frames N      exit after presenting N frames (0: run until closed)
+//   --trace FILE    write a Chrome trace of the run (CRISS_CROSS_TRACE builds)
+//   --record FILE   write the tablet samples of the run to FILE
+//   --replay FILE   draw the samples recorded in FILE instead of tablet
+//                   input, then exit
+//   --speed S       replay at the recorded pace (default) or as fast as
+//                   frames can be presented
+//   --fake          present to an in-process fake instead of a compositor
+//   --size WxH      canvas of a --fake replay (default 1920x1080)
+int main(int argc, char** argv) {
+    options opts;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        auto arg = [&](char const* name) { return std::strcmp(argv[i], name) == 0 && i + 1 < argc; };
+        if (arg("--frames")) {
+            opts.frame_limit = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg("--trace")) {
+            opts.trace_file = argv[++i];
+        }
+        else if (arg("--record")) {
+            opts.record_file = argv[++i];
+        }
+        else if (arg("--replay")) {
+            opts.replay_file = argv[++i];
+        }
+        else if (arg("--speed")) {
+            ++i;
+            opts.max_speed = std::strcmp(argv[i], "max") == 0;
+            usage |= !opts.max_speed && std::strcmp(argv[i], "recorded") != 0;
+        }
+        else if (std::strcmp(argv[i], "--fake") == 0) {
+            opts.fake = true;
+        }
+        else if (arg("--size")) {
+            usage |= std::sscanf(argv[++i], "%dx%d", &opts.width, &opts.height) != 2 || opts.width <= 0 || opts.height <= 0;
+        }
+        else {
+            usage = true;
+        }
+    }
+    if (usage || (opts.fake && !opts.replay_file)) {
+        std::cerr << "usage: " << argv[0] << " [--frames N] [--trace FILE] [--record FILE]\n"
+                  << "       [--replay FILE [--speed recorded|max] [--fake [--size WxH]]]" << std::endl;
+        return 2;
+    }
+
+    int status = 0;
+    try {
+        if (opts.fake) {
+            status = replay_fake(opts);
+        }
+        else {
+            status = run(opts);
+        }
+    }
+    catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (opts.trace_file) {
+#if !defined(CRISS_CROSS_TRACE)
+        std::cerr << "built without CRISS_CROSS_TRACE; " << opts.trace_file << " holds no events" << std::endl;
+#endif
+        std::ofstream out{opts.trace_file};
+        criss_cross::trace::write_json(out);
+        std::cout << "trace: " << opts.trace_file << " dropped: " << criss_cross::trace::dropped() << std::endl;
+    }
+    return status;
 }
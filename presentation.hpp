@@ -0,0 +1,366 @@
+#ifndef INCLUDE_PRESENTATION_HPP
+#define INCLUDE_PRESENTATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <array>
+#include <span>
+#include <chrono>
+#include <algorithm>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/udmabuf.h>
+
+#include <wayland-client.h>
+#include <zwp-linux-dmabuf-v1-client.h>
+
+#include "damage.hpp"
+#include "trace.hpp"
+
+namespace criss_cross
+{
+    // fourcc codes from drm_fourcc.h, spelled out to avoid a libdrm dependency
+    constexpr uint32_t drm_format_argb8888 = 0x34325241; // 'AR24'
+    constexpr uint32_t drm_format_xrgb8888 = 0x34325258; // 'XR24'
+    constexpr uint64_t drm_format_mod_linear = 0;
+
+    class presentation;
+
+    // One pooled ARGB8888 buffer; pixels maps the backing memfd whether the
+    // compositor sees it as a dmabuf or as wl_shm.
+    struct frame_buffer {
+        presentation* owner = nullptr;
+        wl_buffer* proxy = nullptr;
+        uint32_t* pixels = nullptr;
+        size_t length = 0;
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+        bool dmabuf = false;
+        bool busy = false;   // attached and not yet released by the compositor
+        unsigned age = 0;    // frames since these contents were presented, 0 if undefined
+    };
+
+    struct presentation_stats {
+        using duration = std::chrono::steady_clock::duration;
+
+        size_t dmabuf_allocations = 0;
+        size_t shm_allocations = 0;
+        size_t dmabuf_failures = 0;
+        size_t frames = 0;
+        size_t starved = 0;      // acquire found every buffer held by the compositor
+
+        duration render_last{};  // acquire -> submit
+        duration render_max{};
+        duration render_total{};
+        duration latency_last{}; // submit -> wl_surface.frame done
+        duration latency_max{};
+        duration latency_total{};
+        size_t latency_samples = 0;
+    };
+
+    // Pool of 2 to max_buffers reusable buffers attached to one surface.
+    // Buffers are dmabufs made from memfds through /dev/udmabuf when the
+    // compositor advertises a LINEAR ARGB8888 or XRGB8888 modifier, and plain
+    // wl_shm otherwise; either way they are allocated once and recycled on
+    // wl_buffer.release.
+    class presentation {
+    public:
+        using clock = std::chrono::steady_clock;
+        constexpr static size_t max_buffers = 3;
+
+    public:
+        presentation(wl_display* display, wl_surface* surface, wl_shm* shm,
+                     zwp_linux_dmabuf_v1* dmabuf, int width, int height, size_t count = 2)
+            : display{display}
+            , surface{surface}
+            , shm{shm}
+            , dmabuf{dmabuf}
+            , count{std::clamp<size_t>(count, 2, max_buffers)}
+            , width{width}
+            , height{height}
+        {
+            if (dmabuf) {
+                udmabuf = ::open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+                zwp_linux_dmabuf_v1_add_listener(dmabuf, &dmabuf_listener, this);
+                wl_display_roundtrip(display);
+            }
+            for (size_t i = 0; i < this->count; ++i) {
+                allocate(buffers[i]);
+            }
+        }
+        presentation(presentation const&) = delete;
+        presentation& operator=(presentation const&) = delete;
+
+        ~presentation() {
+            for (size_t i = 0; i < count; ++i) {
+                release(buffers[i]);
+            }
+            if (callback) {
+                wl_callback_destroy(callback);
+            }
+            if (udmabuf >= 0) {
+                ::close(udmabuf);
+            }
+        }
+
+    public:
+        presentation_stats const& stats() const noexcept { return statistics; }
+        bool frame_pending() const noexcept { return callback != nullptr; }
+        bool dmabuf_usable() const noexcept { return udmabuf >= 0 && format != 0; }
+        size_t size() const noexcept { return count; }
+
+        // Returns an idle buffer, preferring the most recently presented
+        // contents, or nullptr when every buffer is still held by the
+        // compositor and the pool is already at max_buffers.
+        frame_buffer* acquire() {
+            frame_buffer* ret = nullptr;
+            for (size_t i = 0; i < count; ++i) {
+                auto& b = buffers[i];
+                if (b.busy) continue;
+                if (!ret || (b.age != 0 && (ret->age == 0 || b.age < ret->age))) {
+                    ret = &b;
+                }
+            }
+            if (!ret && count < max_buffers) {
+                ret = &buffers[count++];
+                allocate(*ret);
+            }
+            if (!ret) {
+                ++statistics.starved;
+                return nullptr;
+            }
+            acquired_at = clock::now();
+            return ret;
+        }
+
+        // Attaches b with whole-buffer damage, requests a frame callback and
+        // commits.
+        void submit(frame_buffer& b) {
+            wl_surface_attach(surface, b.proxy, 0, 0);
+            wl_surface_damage_buffer(surface, 0, 0, b.width, b.height);
+            commit(b);
+        }
+
+        // Same, but only the given rectangles are reported as damaged.
+        void submit(frame_buffer& b, std::span<damage_rect const> damage) {
+            wl_surface_attach(surface, b.proxy, 0, 0);
+            for (auto const& r : damage) {
+                wl_surface_damage_buffer(surface, get<0>(r.lo), get<1>(r.lo), r.width(), r.height());
+            }
+            commit(b);
+        }
+
+        // Drops every buffer and allocates count fresh ones at the new size;
+        // buffers still held by the compositor stay valid on its side.
+        void resize(int w, int h) {
+            if (w == width && h == height) return;
+            for (size_t i = 0; i < count; ++i) {
+                release(buffers[i]);
+            }
+            width = w;
+            height = h;
+            for (size_t i = 0; i < count; ++i) {
+                allocate(buffers[i]);
+            }
+        }
+
+    private:
+        void commit(frame_buffer& b) {
+            auto now = clock::now();
+            auto render = now - acquired_at;
+            statistics.render_last = render;
+            statistics.render_max = std::max(statistics.render_max, render);
+            statistics.render_total += render;
+
+            if (callback) {
+                wl_callback_destroy(callback);
+            }
+            callback = wl_surface_frame(surface);
+            wl_callback_add_listener(callback, &frame_listener, this);
+            wl_surface_commit(surface);
+            CRISS_CROSS_TRACE_INSTANT("present.commit", statistics.frames);
+            submitted_at = now;
+
+            for (size_t i = 0; i < count; ++i) {
+                if (buffers[i].age != 0) ++buffers[i].age;
+            }
+            b.age = 1;
+            b.busy = true;
+            ++statistics.frames;
+        }
+
+        void allocate(frame_buffer& b) {
+            b = frame_buffer{};
+            b.owner = this;
+            b.width = width;
+            b.height = height;
+            b.stride = width * 4;
+            auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            b.length = (static_cast<size_t>(b.stride) * height + page - 1) / page * page;
+
+            int fd = ::memfd_create("criss-cross", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "memfd_create");
+            }
+            if (::ftruncate(fd, static_cast<off_t>(b.length)) < 0) {
+                auto err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), "ftruncate");
+            }
+            auto map = ::mmap(nullptr, b.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                auto err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), "mmap");
+            }
+            b.pixels = static_cast<uint32_t*>(map);
+
+            if (dmabuf_usable() && allocate_dmabuf(b, fd)) {
+                b.dmabuf = true;
+                ++statistics.dmabuf_allocations;
+            }
+            else {
+                auto pool = wl_shm_create_pool(shm, fd, static_cast<int32_t>(b.length));
+                b.proxy = wl_shm_pool_create_buffer(pool, 0, b.width, b.height, b.stride, WL_SHM_FORMAT_ARGB8888);
+                wl_shm_pool_destroy(pool);
+                ++statistics.shm_allocations;
+            }
+            ::close(fd);
+            wl_buffer_add_listener(b.proxy, &buffer_listener, &b);
+        }
+
+        bool allocate_dmabuf(frame_buffer& b, int memfd) {
+            if (::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+                return false;
+            }
+            udmabuf_create create{};
+            create.memfd = static_cast<uint32_t>(memfd);
+            create.flags = UDMABUF_FLAGS_CLOEXEC;
+            create.offset = 0;
+            create.size = b.length;
+            int fd = ::ioctl(udmabuf, UDMABUF_CREATE, &create);
+            if (fd < 0) {
+                return false;
+            }
+            params_result result;
+            auto params = zwp_linux_dmabuf_v1_create_params(dmabuf);
+            zwp_linux_buffer_params_v1_add_listener(params, &params_listener, &result);
+            zwp_linux_buffer_params_v1_add(params, fd, 0, 0, static_cast<uint32_t>(b.stride),
+                                           static_cast<uint32_t>(drm_format_mod_linear >> 32),
+                                           static_cast<uint32_t>(drm_format_mod_linear & 0xffffffff));
+            zwp_linux_buffer_params_v1_create(params, b.width, b.height, format, 0);
+            while (!result.done && wl_display_roundtrip(display) != -1) {
+                continue;
+            }
+            zwp_linux_buffer_params_v1_destroy(params);
+            ::close(fd);
+            if (!result.buffer) {
+                // the compositor rejected the import; stop trying for this pool
+                ++statistics.dmabuf_failures;
+                format = 0;
+                return false;
+            }
+            b.proxy = result.buffer;
+            return true;
+        }
+
+        static void release(frame_buffer& b) noexcept {
+            if (b.proxy) {
+                wl_buffer_destroy(b.proxy);
+            }
+            if (b.pixels) {
+                ::munmap(b.pixels, b.length);
+            }
+            b = frame_buffer{};
+        }
+
+    private:
+        struct params_result {
+            wl_buffer* buffer = nullptr;
+            bool done = false;
+        };
+
+        // zwp_linux_dmabuf_v1
+        static void on_format(void*, zwp_linux_dmabuf_v1*, uint32_t) {
+        }
+        static void on_modifier(void* data, zwp_linux_dmabuf_v1*, uint32_t fourcc, uint32_t hi, uint32_t lo) {
+            auto self = static_cast<presentation*>(data);
+            auto modifier = (static_cast<uint64_t>(hi) << 32) | lo;
+            if (modifier != drm_format_mod_linear) return;
+            if (fourcc == drm_format_argb8888) {
+                self->format = fourcc;
+            }
+            else if (fourcc == drm_format_xrgb8888 && self->format == 0) {
+                self->format = fourcc;
+            }
+        }
+
+        // zwp_linux_buffer_params_v1
+        static void on_created(void* data, zwp_linux_buffer_params_v1*, wl_buffer* buffer) {
+            auto result = static_cast<params_result*>(data);
+            result->buffer = buffer;
+            result->done = true;
+        }
+        static void on_failed(void* data, zwp_linux_buffer_params_v1*) {
+            static_cast<params_result*>(data)->done = true;
+        }
+
+        // wl_buffer
+        static void on_release(void* data, wl_buffer*) {
+            static_cast<frame_buffer*>(data)->busy = false;
+        }
+
+        // wl_callback
+        static void on_frame(void* data, wl_callback* cb, uint32_t) {
+            auto self = static_cast<presentation*>(data);
+            CRISS_CROSS_TRACE_INSTANT("present.frame_done", self->statistics.frames);
+            auto latency = clock::now() - self->submitted_at;
+            auto& s = self->statistics;
+            s.latency_last = latency;
+            s.latency_max = std::max(s.latency_max, latency);
+            s.latency_total += latency;
+            ++s.latency_samples;
+            wl_callback_destroy(cb);
+            self->callback = nullptr;
+        }
+
+        constexpr static zwp_linux_dmabuf_v1_listener dmabuf_listener = {
+            .format = on_format,
+            .modifier = on_modifier,
+        };
+        constexpr static zwp_linux_buffer_params_v1_listener params_listener = {
+            .created = on_created,
+            .failed = on_failed,
+        };
+        constexpr static wl_buffer_listener buffer_listener = {
+            .release = on_release,
+        };
+        constexpr static wl_callback_listener frame_listener = {
+            .done = on_frame,
+        };
+
+    private:
+        wl_display* display;
+        wl_surface* surface;
+        wl_shm* shm;
+        zwp_linux_dmabuf_v1* dmabuf;
+        int udmabuf = -1;
+        uint32_t format = 0;    // LINEAR dmabuf format, 0 when none is usable
+        size_t count;
+        int width;
+        int height;
+        std::array<frame_buffer, max_buffers> buffers;
+        wl_callback* callback = nullptr;
+        clock::time_point acquired_at;
+        clock::time_point submitted_at;
+        presentation_stats statistics;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_PRESENTATION_HPP
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include "raster.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Headless frame: a batch of pen strokes drawn into a 1080p memory
+    // canvas, on pools of 1 to 16 threads.
+    std::vector<std::vector<criss_cross::stroke_vertex>> random_strokes(size_t count, size_t length) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<float> x{0.0f, 1920.0f}, y{0.0f, 1080.0f}, step{-6.0f, 6.0f};
+        std::vector<std::vector<criss_cross::stroke_vertex>> ret(count);
+        for (auto& s : ret) {
+            aux::versor<float, 2> p{x(gen), y(gen)};
+            for (size_t i = 0; i < length; ++i) {
+                p += aux::versor<float, 2>{step(gen) + 3.0f, step(gen)};
+                s.push_back({p, 1.5f + 4.0f * std::abs(std::sin(static_cast<float>(i) * 0.05f))});
+            }
+        }
+        return ret;
+    }
+
+    void raster_strokes(benchmark::State& state) {
+        auto threads = static_cast<size_t>(state.range(0));
+        auto vertices = random_strokes(256, 256);
+        std::vector<criss_cross::stroke> strokes;
+        for (auto const& v : vertices) strokes.push_back({v, 0xe0101820u});
+
+        aux::thread_pool pool{threads};
+        criss_cross::rasterizer raster{pool};
+        criss_cross::memory_canvas canvas{1920, 1080, 0xffffffffu};
+        for (auto _ : state) {
+            raster.draw(canvas.view(), strokes);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(raster.stats().segments));
+        state.counters["tiles/frame"] = static_cast<double>(raster.stats().tiles) / state.iterations();
+    }
+} // namespace
+
+BENCHMARK(raster_strokes)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
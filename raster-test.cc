@@ -0,0 +1,143 @@
+
+#include <gtest/gtest.h>
+
+#include "raster.hpp"
+
+#include <aux/arena.hpp>
+
+#include <vector>
+#include <memory_resource>
+
+class raster_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+using criss_cross::stroke;
+using criss_cross::stroke_vertex;
+using criss_cross::memory_canvas;
+using criss_cross::rasterizer;
+
+namespace
+{
+    constexpr uint32_t white = 0xffffffffu;
+    constexpr uint32_t black = 0xff000000u;
+
+    std::vector<stroke_vertex> wave(int n, float x0, float y0) {
+        std::vector<stroke_vertex> ret;
+        for (int i = 0; i < n; ++i) {
+            float t = static_cast<float>(i);
+            ret.push_back({{x0 + t * 7.0f, y0 + 40.0f * std::sin(t * 0.2f)}, 1.0f + (i % 9)});
+        }
+        return ret;
+    }
+}
+
+TEST_F(raster_test, dot) {
+    aux::thread_pool pool{1};
+    rasterizer raster{pool, 16};
+    memory_canvas canvas{64, 64, white};
+    stroke_vertex v{{32.0f, 32.0f}, 4.0f};
+    stroke s{{&v, 1}, black};
+    raster.draw(canvas.view(), {&s, 1});
+
+    ASSERT_EQ(canvas(32, 32), black);
+    ASSERT_EQ(canvas(29, 32), black);
+    ASSERT_EQ(canvas(40, 32), white);
+    ASSERT_EQ(canvas(0, 0), white);
+    // the rim is partially covered
+    auto rim = canvas(35, 32) & 0xff;
+    ASSERT_GT(rim, 0u);
+    ASSERT_LT(rim, 255u);
+    ASSERT_EQ(raster.stats().segments, 1);
+    ASSERT_EQ(raster.stats().tiles, 4);
+}
+
+TEST_F(raster_test, joints) {
+    // a half-transparent stroke doubling back on itself stays uniform
+    aux::thread_pool pool{1};
+    rasterizer raster{pool};
+    memory_canvas canvas{64, 64, 0};
+    std::vector<stroke_vertex> v{{{10.0f, 32.0f}, 3.0f}, {{50.0f, 32.0f}, 3.0f}, {{20.0f, 32.0f}, 3.0f}};
+    stroke s{v, 0x80800000u};
+    raster.draw(canvas.view(), {&s, 1});
+    ASSERT_EQ(canvas(30, 32), 0x80800000u);
+    ASSERT_EQ(canvas(45, 32), 0x80800000u);
+}
+
+TEST_F(raster_test, deterministic) {
+    auto a = wave(200, -20.0f, 100.0f);
+    auto b = wave(150, 30.0f, 180.0f);
+    std::vector<stroke> strokes{{a, 0xff203040u}, {b, 0x80402010u}, {a, 0x40000040u}};
+
+    aux::thread_pool single{1};
+    rasterizer reference{single, 512};
+    memory_canvas expected{300, 260, white};
+    reference.draw(expected.view(), strokes);
+    ASSERT_EQ(reference.stats().tiles, 1);
+
+    for (size_t threads : {1, 2, 4, 7}) {
+        aux::thread_pool pool{threads};
+        for (int tile : {16, 32, 64}) {
+            rasterizer raster{pool, tile};
+            memory_canvas canvas{300, 260, white};
+            raster.draw(canvas.view(), strokes);
+            ASSERT_TRUE(std::ranges::equal(canvas.data(), expected.data())) << threads << " " << tile;
+        }
+    }
+}
+
+TEST_F(raster_test, damage) {
+    auto a = wave(60, 5.0f, 60.0f);
+    stroke s{a, black};
+    criss_cross::damage_tracker damage{{512, 128}, 32};
+    damage.commit();
+    rasterizer::damage(damage, {&s, 1});
+
+    aux::thread_pool pool{2};
+    rasterizer raster{pool, 32};
+    memory_canvas canvas{512, 128, white};
+    raster.draw(canvas.view(), {&s, 1});
+
+    // every touched pixel lies inside the reported damage
+    auto rects = damage.frame_damage();
+    for (int y = 0; y < canvas.height(); ++y) {
+        for (int x = 0; x < canvas.width(); ++x) {
+            if (canvas(x, y) == white) continue;
+            ASSERT_TRUE(std::ranges::any_of(rects, [x, y](auto const& r) {
+                return get<0>(r.lo) <= x && x < get<0>(r.hi) && get<1>(r.lo) <= y && y < get<1>(r.hi);
+            })) << x << "," << y;
+        }
+    }
+}
+
+TEST_F(raster_test, steady_state) {
+    // the render loop of main: a growing stroke drawn a piece per frame,
+    // with its stroke list in the frame arena, allocates nothing once warm
+    if (!aux::heap_counting()) GTEST_SKIP() << "heap allocations not counted";
+    aux::thread_pool pool{4};
+    rasterizer raster{pool, 32};
+    memory_canvas canvas{512, 256, white};
+    criss_cross::damage_tracker damage{{512, 256}, 32};
+    aux::frame_arena arena;
+    auto path = wave(70, 5.0f, 128.0f);
+    std::vector<stroke_vertex> vertices;
+    size_t heap = 0;
+    for (size_t frame = 0; frame < 200; ++frame) {
+        if (frame == 100) heap = aux::heap_allocations();
+        auto first = path.begin() + static_cast<ptrdiff_t>(frame % (path.size() - 8));
+        vertices.assign(first, first + 8);
+        {
+            std::pmr::vector<stroke> pieces{&arena};
+            pieces.push_back({std::span{vertices}.first(4), black});
+            pieces.push_back({std::span{vertices}.subspan(3), black});
+            raster.draw(canvas.view(), pieces);
+            rasterizer::damage(damage, pieces);
+        }
+        ASSERT_FALSE(damage.repaint(2).empty());
+        damage.commit();
+        arena.reset();
+    }
+    ASSERT_EQ(aux::heap_allocations(), heap);
+}
@@ -0,0 +1,303 @@
+#ifndef INCLUDE_RASTER_HPP
+#define INCLUDE_RASTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <bit>
+#include <span>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include <aux/versor.hpp>
+#include <aux/thread-pool.hpp>
+
+#include "damage.hpp"
+#include "blend.hpp"
+#include "trace.hpp"
+
+namespace criss_cross
+{
+    // Pixel grid the rasterizer draws into; 0xAARRGGBB premultiplied words
+    // (B, G, R, A bytes, see blend.hpp), stride counted in pixels.  A
+    // frame_buffer or a memory_canvas.
+    struct canvas_view {
+        uint32_t* pixels;
+        int width;
+        int height;
+        int stride;
+
+        uint32_t* row(int y) const noexcept { return pixels + static_cast<size_t>(y) * stride; }
+    };
+
+    // Headless target: a plain heap buffer, used for benchmarks and tests
+    // and as the persistent layer strokes accumulate in.
+    class memory_canvas {
+    public:
+        memory_canvas(int width, int height, uint32_t color = 0)
+            : w{width}
+            , h{height}
+            , pixels(static_cast<size_t>(width) * height, color)
+        {
+        }
+
+    public:
+        canvas_view view() noexcept { return {pixels.data(), w, h, w}; }
+        int width() const noexcept { return w; }
+        int height() const noexcept { return h; }
+        uint32_t operator()(int x, int y) const noexcept { return pixels[static_cast<size_t>(y) * w + x]; }
+        std::span<uint32_t const> data() const noexcept { return pixels; }
+        void clear(uint32_t color) noexcept { std::fill(pixels.begin(), pixels.end(), color); }
+
+    private:
+        int w;
+        int h;
+        std::vector<uint32_t> pixels;
+    };
+
+    struct stroke_vertex {
+        aux::versor<float, 2> position;
+        float radius;   // pressure-scaled half width
+    };
+
+    // A run of connected vertices drawn in one premultiplied ARGB colour.
+    // Overlapping segments of one stroke take the maximum coverage, so joints
+    // do not darken.
+    struct stroke {
+        std::span<stroke_vertex const> vertices;
+        uint32_t color;
+    };
+
+    struct raster_stats {
+        size_t segments = 0;
+        size_t tiles = 0;
+        std::chrono::steady_clock::duration elapsed{};
+    };
+
+    // Antialiased variable-width stroke rasterizer.  Segments are binned
+    // into square tiles and the tiles are rendered in parallel; every tile
+    // walks its segments in submission order, so the output does not depend
+    // on the number of threads.
+    class rasterizer {
+    public:
+        explicit rasterizer(aux::thread_pool& pool, int tile = 64)
+            : pool{pool}
+            , tile{tile}
+            , scratches(std::min<size_t>(pool.concurrency(), 64))
+        {
+            for (auto& s : scratches) s.resize(tile);
+        }
+
+    public:
+        raster_stats const& stats() const noexcept { return statistics; }
+
+        void draw(canvas_view target, std::span<stroke const> strokes) {
+            CRISS_CROSS_TRACE_SCOPE("raster.draw", strokes.size());
+            auto start = std::chrono::steady_clock::now();
+            bin(target, strokes);
+            pool.parallel_for(active.size(), [&](size_t i) {
+                CRISS_CROSS_TRACE_SCOPE("raster.tile", active[i]);
+                render_tile(target, strokes, active[i]);
+            });
+            statistics.tiles += active.size();
+            statistics.elapsed += std::chrono::steady_clock::now() - start;
+        }
+
+        // Adds the pixels draw() would touch for these strokes to a tracker.
+        static void damage(damage_tracker& tracker, std::span<stroke const> strokes) noexcept {
+            for (auto const& s : strokes) {
+                for (size_t i = 0; i < segment_count(s); ++i) {
+                    auto const& a = s.vertices[i];
+                    auto const& b = segment_end(s, i);
+                    tracker.add(a.position, b.position, std::max(a.radius, b.radius));
+                }
+            }
+        }
+
+    private:
+        struct segment_ref {
+            uint32_t stroke;
+            uint32_t vertex;   // segment vertex, vertex + 1 (equal for a dot)
+        };
+
+        // A stroke of n > 1 vertices has n - 1 segments; a single vertex is
+        // one degenerate segment, a dot.
+        static size_t segment_count(stroke const& s) noexcept {
+            return s.vertices.size() > 1 ? s.vertices.size() - 1 : s.vertices.size();
+        }
+        static stroke_vertex const& segment_end(stroke const& s, size_t i) noexcept {
+            return s.vertices[std::min(i + 1, s.vertices.size() - 1)];
+        }
+
+        // Pixel bounds [lo, hi) of a segment, antialiasing fringe included.
+        static damage_rect bounds(stroke_vertex const& a, stroke_vertex const& b) noexcept {
+            auto r = std::max(a.radius, b.radius) + 1;
+            auto lo = aux::min(a.position, b.position);
+            auto hi = aux::max(a.position, b.position);
+            return {
+                {static_cast<int>(std::floor(get<0>(lo) - r)), static_cast<int>(std::floor(get<1>(lo) - r))},
+                {static_cast<int>(std::ceil(get<0>(hi) + r)) + 1, static_cast<int>(std::ceil(get<1>(hi) + r)) + 1},
+            };
+        }
+
+        void bin(canvas_view target, std::span<stroke const> strokes) {
+            tiles_x = (target.width + tile - 1) / tile;
+            tiles_y = (target.height + tile - 1) / tile;
+            auto n = static_cast<size_t>(tiles_x) * tiles_y;
+            if (bins.size() < n) bins.resize(n);
+            for (auto i : active) bins[i].clear();
+            active.clear();
+
+            for (uint32_t s = 0; s < strokes.size(); ++s) {
+                auto const& st = strokes[s];
+                for (uint32_t i = 0; i < segment_count(st); ++i) {
+                    auto box = bounds(st.vertices[i], segment_end(st, i));
+                    int x0 = std::max(get<0>(box.lo), 0) / tile;
+                    int y0 = std::max(get<1>(box.lo), 0) / tile;
+                    int x1 = std::min(get<0>(box.hi), target.width) - 1;
+                    int y1 = std::min(get<1>(box.hi), target.height) - 1;
+                    ++statistics.segments;
+                    if (x1 < 0 || y1 < 0) continue;
+                    x1 /= tile;
+                    y1 /= tile;
+                    for (int ty = y0; ty <= y1; ++ty) {
+                        for (int tx = x0; tx <= x1; ++tx) {
+                            auto& bin = bins[static_cast<size_t>(ty) * tiles_x + tx];
+                            if (bin.empty()) active.push_back(static_cast<size_t>(ty) * tiles_x + tx);
+                            bin.push_back({s, i});
+                        }
+                    }
+                }
+            }
+        }
+
+        void render_tile(canvas_view target, std::span<stroke const> strokes, size_t index) const noexcept {
+            int tx = static_cast<int>(index % tiles_x) * tile;
+            int ty = static_cast<int>(index / tiles_x) * tile;
+            int tw = std::min(tile, target.width - tx);
+            int th = std::min(tile, target.height - ty);
+
+            // per-tile coverage scratch, one stroke at a time; every pixel
+            // written is zeroed again when it is blended
+            auto slot = claim();
+            thread_local scratch overflow;
+            auto& [coverage, mask] = slot < scratches.size() ? scratches[slot] : overflow;
+            coverage_guard guard{*this, slot};
+            if (coverage.size() < static_cast<size_t>(tile) * tile) overflow.resize(tile);
+
+            auto const& bin = bins[index];
+            for (size_t k = 0; k < bin.size(); ) {
+                auto s = bin[k].stroke;
+                int cx0 = tw, cy0 = th, cx1 = 0, cy1 = 0;
+                for (; k < bin.size() && bin[k].stroke == s; ++k) {
+                    auto const& a = strokes[s].vertices[bin[k].vertex];
+                    auto const& b = segment_end(strokes[s], bin[k].vertex);
+                    auto box = bounds(a, b);
+                    int x0 = std::max(get<0>(box.lo) - tx, 0);
+                    int y0 = std::max(get<1>(box.lo) - ty, 0);
+                    int x1 = std::min(get<0>(box.hi) - tx, tw);
+                    int y1 = std::min(get<1>(box.hi) - ty, th);
+                    if (x0 >= x1 || y0 >= y1) continue;
+                    cover(a, b, tx, ty, x0, y0, x1, y1, coverage.data());
+                    cx0 = std::min(cx0, x0);
+                    cy0 = std::min(cy0, y0);
+                    cx1 = std::max(cx1, x1);
+                    cy1 = std::max(cy1, y1);
+                }
+                // coverage -> 8-bit mask -> premultiplied dab, one row at a time
+                auto argb = strokes[s].color;
+                pixel color{argb & 0xff, (argb >> 8) & 0xff, (argb >> 16) & 0xff, argb >> 24};
+                for (int y = cy0; y < cy1; ++y) {
+                    auto cov = coverage.data() + static_cast<size_t>(y) * tile;
+                    for (int x = cx0; x < cx1; ++x) {
+                        mask[static_cast<size_t>(x - cx0)] = static_cast<uint8_t>(cov[x] * 255 + 0.5f);
+                        cov[x] = 0;
+                    }
+                    auto n = static_cast<size_t>(std::max(cx1 - cx0, 0));
+                    auto row = reinterpret_cast<pixel*>(target.row(ty + y) + tx + cx0);
+                    dab(std::span<pixel>{row, n}, std::span<uint8_t const>{mask.data(), n}, color);
+                }
+            }
+        }
+
+        // Scratch slots are made up front, one per pool thread, so drawing
+        // allocates nothing once the bins have grown; a tile claims a free
+        // slot for its duration.  More threads than slots (callers sharing
+        // the pool) fall back to a scratch of their own.
+        struct scratch {
+            std::vector<float> coverage;
+            std::vector<uint8_t> mask;
+
+            void resize(int tile) {
+                coverage.assign(static_cast<size_t>(tile) * tile, 0.0f);
+                mask.resize(static_cast<size_t>(tile));
+            }
+        };
+        struct coverage_guard {
+            rasterizer const& owner;
+            size_t slot;
+            ~coverage_guard() {
+                if (slot < owner.scratches.size()) {
+                    owner.claimed.fetch_and(~(uint64_t{1} << slot), std::memory_order_release);
+                }
+            }
+        };
+        size_t claim() const noexcept {
+            auto all = scratches.size() < 64 ? (uint64_t{1} << scratches.size()) - 1 : ~uint64_t{0};
+            auto bits = claimed.load(std::memory_order_relaxed);
+            for (;;) {
+                auto free = ~bits & all;
+                if (!free) return scratches.size();
+                auto slot = static_cast<size_t>(std::countr_zero(free));
+                if (claimed.compare_exchange_weak(bits, bits | uint64_t{1} << slot, std::memory_order_acquire)) {
+                    return slot;
+                }
+            }
+        }
+
+        // Max-accumulates the coverage of capsule a-b (radius interpolated
+        // along the segment) over tile pixels [x0, x1) x [y0, y1).
+        void cover(stroke_vertex const& a, stroke_vertex const& b, int tx, int ty,
+                   int x0, int y0, int x1, int y1, float* coverage) const noexcept
+        {
+            auto ab = b.position - a.position;
+            auto len2 = aux::inner(ab, ab);
+            auto inv = len2 > 0 ? 1 / len2 : 0.0f;
+            auto dr = b.radius - a.radius;
+            float ax = get<0>(a.position), ay = get<1>(a.position);
+            float abx = get<0>(ab), aby = get<1>(ab);
+            float reach = std::max(a.radius, b.radius) + 0.5f;
+            float reach2 = reach * reach;
+            for (int y = y0; y < y1; ++y) {
+                float py = static_cast<float>(ty + y) + 0.5f - ay;
+                auto cov = coverage + static_cast<size_t>(y) * tile;
+                for (int x = x0; x < x1; ++x) {
+                    float px = static_cast<float>(tx + x) + 0.5f - ax;
+                    float t = std::clamp((px * abx + py * aby) * inv, 0.0f, 1.0f);
+                    float dx = px - abx * t;
+                    float dy = py - aby * t;
+                    float d2 = dx * dx + dy * dy;
+                    if (d2 >= reach2) continue;
+                    float d = std::sqrt(d2);
+                    float c = std::clamp(a.radius + dr * t - d + 0.5f, 0.0f, 1.0f);
+                    cov[x] = std::max(cov[x], c);
+                }
+            }
+        }
+
+    private:
+        aux::thread_pool& pool;
+        int tile;
+        int tiles_x = 0;
+        int tiles_y = 0;
+        std::vector<std::vector<segment_ref>> bins;   // per tile, reused between draws
+        std::vector<size_t> active;                   // tiles with a non-empty bin
+        mutable std::vector<scratch> scratches;
+        mutable std::atomic<uint64_t> claimed = 0;    // bit per slot in use
+        raster_stats statistics;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_RASTER_HPP
@@ -0,0 +1,176 @@
+
+#include <gtest/gtest.h>
+
+#include "replay.hpp"
+#include "ink.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+class replay_test : public testing::Test {
+protected:
+    void SetUp() override {
+        path = testing::TempDir() + "replay-test.rec";
+    }
+    void TearDown() override {
+        ::unlink(path.c_str());
+    }
+
+    std::string path;
+};
+
+using criss_cross::tablet_sample;
+using criss_cross::replay_source;
+
+namespace
+{
+    constexpr uint32_t paper = 0xfff4f1eau;
+    constexpr uint32_t ink_color = 0xff202020u;
+
+    tablet_sample sample(uint32_t time, bool down, float x = 0, float y = 0, float pressure = 0) {
+        return {time, uint16_t{0}, static_cast<uint8_t>(down ? criss_cross::tablet_down : 0), x, y, pressure, 0.0f, 0.0f};
+    }
+
+    // Two pen strokes at 200 Hz with a rest between them, the clock
+    // wrapping in the first.
+    std::vector<tablet_sample> strokes() {
+        std::vector<tablet_sample> ret;
+        uint32_t t = 0xffffff00u;
+        for (int s = 0; s < 2; ++s) {
+            for (int i = 0; i < 150; ++i, t += 5) {
+                auto u = static_cast<float>(i);
+                ret.push_back(sample(t, true, 40.0f + u * 3.0f, 100.0f + s * 150.0f + 50.0f * std::sin(u * 0.1f),
+                                     0.3f + 0.5f * std::abs(std::sin(u * 0.05f))));
+            }
+            ret.push_back(sample(t, false));
+            t += 400;
+        }
+        return ret;
+    }
+
+    struct result {
+        uint64_t layer;
+        uint64_t front;
+        size_t strokes;
+        size_t frames;
+    };
+
+    // The drawing path of criss-cross --replay --fake: every frame of the
+    // recording drawn into the layer on its own, the damage presented
+    // every present_every frames.
+    result play(std::span<tablet_sample const> samples, unsigned threads, size_t present_every) {
+        constexpr int width = 600;
+        constexpr int height = 400;
+        criss_cross::ink_queue ink;
+        criss_cross::ink_processor process{ink, 4.0f};
+        aux::thread_pool pool{threads};
+        criss_cross::rasterizer raster{pool};
+        criss_cross::memory_canvas layer{width, height, paper};
+        criss_cross::damage_tracker damage{{width, height}};
+        criss_cross::fake_presentation present{width, height};
+        std::vector<criss_cross::stroke_vertex> vertices;
+        std::vector<size_t> starts;
+        auto show = [&] {
+            if (damage.empty()) return;
+            auto b = present.acquire();
+            criss_cross::canvas_view target{b->pixels, b->width, b->height, b->stride / 4};
+            for (auto const& r : damage.repaint(b->age)) {
+                for (int y = get<1>(r.lo); y < get<1>(r.hi); ++y) {
+                    std::copy_n(layer.view().row(y) + get<0>(r.lo), r.width(), target.row(y) + get<0>(r.lo));
+                }
+            }
+            present.submit(*b, damage.frame_damage());
+            damage.commit();
+        };
+        replay_source source{samples};
+        while (!source.done()) {
+            process(source.next());
+            {
+                std::lock_guard lock{ink.mutex};
+                std::swap(vertices, ink.vertices);
+                std::swap(starts, ink.starts);
+            }
+            std::vector<criss_cross::stroke> pieces;
+            for (size_t i = 0; i < starts.size(); ++i) {
+                auto end = i + 1 < starts.size() ? starts[i + 1] : vertices.size();
+                pieces.push_back({std::span{vertices}.subspan(starts[i], end - starts[i]), ink_color});
+            }
+            raster.draw(layer.view(), pieces);
+            criss_cross::rasterizer::damage(damage, pieces);
+            vertices.clear();
+            starts.clear();
+            if (source.frame() % present_every == 0) show();
+        }
+        show();
+        auto front = present.front();
+        return {
+            criss_cross::checksum(layer.view()),
+            front ? criss_cross::checksum({front->pixels, front->width, front->height, front->stride / 4}) : 0,
+            ink.strokes,
+            source.frame(),
+        };
+    }
+} // namespace
+
+TEST_F(replay_test, frames_of_recorded_time) {
+    // 10 ms frames; the clock wraps between the third and fourth samples
+    // and steps back before the last but one
+    uint32_t base = 0xfffffffau;
+    std::vector<tablet_sample> samples = {
+        sample(base, true), sample(base + 3, true), sample(base + 9, true),
+        sample(base + 10, true),
+        sample(base + 25, true), sample(base + 24, true),
+        sample(base + 40, false),
+    };
+    replay_source source{samples, 100};
+    ASSERT_EQ(source.size(), 7);
+    ASSERT_EQ(source.due(), std::chrono::milliseconds{10});
+    std::vector<size_t> sizes;
+    while (!source.done()) {
+        sizes.push_back(source.next().size());
+    }
+    ASSERT_EQ(sizes, (std::vector<size_t>{3, 1, 2, 0, 1}));
+    ASSERT_EQ(source.frame(), 5);
+    ASSERT_EQ(source.due(), std::chrono::milliseconds{60});
+
+    replay_source empty{{}};
+    ASSERT_TRUE(empty.done());
+}
+
+TEST_F(replay_test, record_round_trip) {
+    auto const samples = strokes();
+    {
+        criss_cross::tablet_recorder recorder{path.c_str(), 256};
+        for (size_t i = 0; i < samples.size(); i += 7) {
+            recorder.append(std::span{samples}.subspan(i, std::min<size_t>(7, samples.size() - i)));
+        }
+        ASSERT_EQ(recorder.size(), samples.size());
+    }
+    criss_cross::tablet_recording recording{path.c_str()};
+    ASSERT_EQ(recording.size(), samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_EQ(get<criss_cross::sample_time>(recording[i]), get<criss_cross::sample_time>(samples[i])) << i;
+        ASSERT_EQ(get<criss_cross::sample_state>(recording[i]), get<criss_cross::sample_state>(samples[i])) << i;
+        ASSERT_EQ(get<criss_cross::sample_x>(recording[i]), get<criss_cross::sample_x>(samples[i])) << i;
+        ASSERT_EQ(get<criss_cross::sample_pressure>(recording[i]), get<criss_cross::sample_pressure>(samples[i])) << i;
+    }
+}
+
+TEST_F(replay_test, reproducible) {
+    auto const samples = strokes();
+    auto a = play(samples, 1, 1);
+    ASSERT_EQ(a.strokes, 2);
+    ASSERT_EQ(a.layer, a.front);
+    ASSERT_NE(a.layer, criss_cross::checksum(criss_cross::memory_canvas{600, 400, paper}.view()));
+    // the layer does not depend on the rasterizer's threads or on how
+    // often frames are presented
+    for (unsigned threads : {1u, 3u}) {
+        for (size_t every : {1u, 3u, 1000u}) {
+            auto b = play(samples, threads, every);
+            ASSERT_EQ(b.layer, a.layer) << threads << " " << every;
+            ASSERT_EQ(b.front, a.layer) << threads << " " << every;
+            ASSERT_EQ(b.frames, a.frames);
+        }
+    }
+}
@@ -0,0 +1,198 @@
+#ifndef INCLUDE_REPLAY_HPP
+#define INCLUDE_REPLAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <array>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include <sys/resource.h>
+
+#include <aux/record-file.hpp>
+
+#include "tablet-sample.hpp"
+#include "damage.hpp"
+#include "raster.hpp"
+
+namespace criss_cross
+{
+    // tablet_sample streams on disk (see aux/record-file.hpp); criss-cross
+    // --record writes one, --replay reads it.
+    using tablet_recorder = aux::record_writer<uint32_t, uint16_t, uint8_t, float, float, float, float, float>;
+    using tablet_recording = aux::record_file<uint32_t, uint16_t, uint8_t, float, float, float, float, float>;
+    static_assert(std::same_as<tablet_recording::record_type, tablet_sample>);
+
+    // Cuts a recorded sample stream into frames of recorded time: frame k
+    // holds the samples stamped in the k-th period of 1 / frame_rate after
+    // the first sample.  The cut depends on the recording alone, so every
+    // replay of it hands the same batches to the ink processor, in the same
+    // order, whatever the pacing.  Timestamps are taken as differences from
+    // the previous sample, so the 32-bit millisecond clock may wrap; a step
+    // back counts as none.
+    class replay_source {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    public:
+        explicit replay_source(std::span<tablet_sample const> samples, unsigned frame_rate = 60) noexcept
+            : samples{samples}
+            , rate{std::max(frame_rate, 1u)}
+        {
+        }
+
+    public:
+        bool done() const noexcept { return pos == samples.size(); }
+        size_t size() const noexcept { return samples.size(); }
+        size_t frame() const noexcept { return index; }   // frames handed out so far
+
+        // Recorded time from the first sample to the end of the next
+        // frame's period, when all of its samples have arrived.
+        clock::duration due() const noexcept {
+            return std::chrono::nanoseconds{static_cast<int64_t>((index + 1) * 1'000'000'000 / rate)};
+        }
+
+        // The samples of the next frame; none while the pen rested.
+        std::span<tablet_sample const> next() noexcept {
+            auto first = pos;
+            while (pos < samples.size() && elapsed * rate / 1000 <= index) {
+                if (++pos < samples.size()) {
+                    auto step = static_cast<int32_t>(get<sample_time>(samples[pos]) - get<sample_time>(samples[pos - 1]));
+                    elapsed += static_cast<uint64_t>(std::max(step, 0));
+                }
+            }
+            ++index;
+            return samples.subspan(first, pos - first);
+        }
+
+    private:
+        std::span<tablet_sample const> samples;
+        uint64_t rate;
+        size_t pos = 0;
+        size_t index = 0;
+        uint64_t elapsed = 0;   // ms from the first sample to samples[pos]
+    };
+
+    // In-process stand-in for presentation, for replays without a
+    // compositor.  Buffers are heap memory; like a compositor holding what
+    // is on screen, one keeps the buffer last submitted until the next
+    // submit releases it, so buffer ages and damage repaints run as they
+    // would on a display.  Frames are never pending: pacing is the
+    // caller's.
+    class fake_presentation {
+    public:
+        using clock = std::chrono::steady_clock;
+        constexpr static size_t max_buffers = 3;
+
+        struct buffer {
+            uint32_t* pixels = nullptr;
+            int width = 0;
+            int height = 0;
+            int stride = 0;      // bytes, as frame_buffer
+            bool busy = false;
+            unsigned age = 0;    // frames since these contents were presented, 0 if undefined
+            std::vector<uint32_t> storage;
+        };
+
+        struct statistics {
+            size_t frames = 0;
+            size_t starved = 0;
+            size_t damaged_pixels = 0;   // submitted damage, summed
+            clock::duration render_max{};
+            clock::duration render_total{};
+        };
+
+    public:
+        fake_presentation(int width, int height, size_t count = 2)
+            : count{std::clamp<size_t>(count, 2, max_buffers)}
+        {
+            resize(width, height);
+        }
+
+    public:
+        statistics const& stats() const noexcept { return counters; }
+        bool frame_pending() const noexcept { return false; }
+
+        // What a compositor would show: the buffer last submitted.
+        buffer const* front() const noexcept { return shown; }
+
+        buffer* acquire() {
+            buffer* ret = nullptr;
+            for (size_t i = 0; i < count; ++i) {
+                auto& b = buffers[i];
+                if (b.busy) continue;
+                if (!ret || (b.age != 0 && (ret->age == 0 || b.age < ret->age))) {
+                    ret = &b;
+                }
+            }
+            if (!ret) {
+                ++counters.starved;
+                return nullptr;
+            }
+            acquired_at = clock::now();
+            return ret;
+        }
+
+        void submit(buffer& b, std::span<damage_rect const> damage) {
+            auto render = clock::now() - acquired_at;
+            counters.render_max = std::max(counters.render_max, render);
+            counters.render_total += render;
+            for (auto const& r : damage) {
+                counters.damaged_pixels += static_cast<size_t>(r.width()) * static_cast<size_t>(r.height());
+            }
+            if (shown) shown->busy = false;
+            for (size_t i = 0; i < count; ++i) {
+                if (buffers[i].age != 0) ++buffers[i].age;
+            }
+            b.age = 1;
+            b.busy = true;
+            shown = &b;
+            ++counters.frames;
+        }
+
+        void resize(int w, int h) {
+            for (size_t i = 0; i < count; ++i) {
+                auto& b = buffers[i];
+                b.storage.assign(static_cast<size_t>(std::max(w, 0)) * static_cast<size_t>(std::max(h, 0)), 0);
+                b.pixels = b.storage.data();
+                b.width = w;
+                b.height = h;
+                b.stride = w * 4;
+                b.busy = false;
+                b.age = 0;
+            }
+            shown = nullptr;
+        }
+
+    private:
+        size_t count;
+        std::array<buffer, max_buffers> buffers;
+        buffer* shown = nullptr;
+        statistics counters;
+        clock::time_point acquired_at;
+    };
+
+    // FNV-1a over the pixel words of a view, row by row; padding past the
+    // width is left out.
+    inline uint64_t checksum(canvas_view v) noexcept {
+        uint64_t h = 0xcbf29ce484222325u;
+        for (int y = 0; y < v.height; ++y) {
+            auto row = v.row(y);
+            for (int x = 0; x < v.width; ++x) {
+                h = (h ^ row[x]) * 0x100000001b3u;
+            }
+        }
+        return h;
+    }
+
+    // Peak resident set of this process so far, bytes.
+    inline size_t peak_rss() noexcept {
+        rusage u{};
+        if (::getrusage(RUSAGE_SELF, &u) != 0) return 0;
+        return static_cast<size_t>(u.ru_maxrss) * 1024;
+    }
+} // ::criss_cross
+
+#endif // INCLUDE_REPLAY_HPP
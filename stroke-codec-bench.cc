@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include "stroke-codec.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+    using point = aux::versor<double, 5>;
+
+    // A large document's worth of pen points, 2 px apart, x, y, pressure
+    // and tilt.
+    std::vector<point> const& document() {
+        static auto const ret = [] {
+            std::mt19937 gen{7};
+            std::uniform_real_distribution<double> turn{-0.15, 0.15}, drift{-0.004, 0.004};
+            std::vector<point> points;
+            double x = 1000, y = 600, heading = 0, pressure = 0.5, tx = 10, ty = -5;
+            for (size_t i = 0; i < 1'000'000; ++i) {
+                heading += turn(gen);
+                x += 2 * std::cos(heading);
+                y += 2 * std::sin(heading);
+                pressure = std::clamp(pressure + drift(gen), 0.0, 1.0);
+                tx += drift(gen) * 10;
+                ty += drift(gen) * 10;
+                points.push_back({x, y, pressure, tx, ty});
+            }
+            return points;
+        }();
+        return ret;
+    }
+
+    void stroke_encode(benchmark::State& state) {
+        criss_cross::stroke_codec<5> codec;
+        auto const& points = document();
+        std::vector<uint8_t> bytes;
+        for (auto _ : state) {
+            bytes.clear();
+            codec.encode(std::span<point const>{points}, bytes);
+            benchmark::DoNotOptimize(bytes.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * points.size() * sizeof (point)));
+        state.counters["ratio"] = static_cast<double>(points.size() * sizeof (point)) / static_cast<double>(bytes.size());
+    }
+
+    // Throughput in decoded bytes, doubles and floats, into a buffer
+    // allocated once as a document loader would.
+    template <class T>
+    void stroke_decode(benchmark::State& state) {
+        criss_cross::stroke_codec<5> codec;
+        auto const& points = document();
+        std::vector<uint8_t> bytes;
+        codec.encode(std::span<point const>{points}, bytes);
+        std::vector<aux::versor<T, 5>> out(points.size());
+        for (auto _ : state) {
+            codec.decode(bytes, std::span{out});
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * points.size() * sizeof (aux::versor<T, 5>)));
+        state.counters["encoded_bytes"] = static_cast<double>(bytes.size());
+    }
+
+    // What reading the full-precision points costs: a plain copy.
+    void stroke_copy(benchmark::State& state) {
+        auto const& points = document();
+        std::vector<point> out(points.size());
+        for (auto _ : state) {
+            std::copy(points.begin(), points.end(), out.begin());
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * points.size() * sizeof (point)));
+    }
+}
+
+BENCHMARK(stroke_copy)->Unit(benchmark::kMillisecond);
+BENCHMARK(stroke_encode)->Unit(benchmark::kMillisecond);
+BENCHMARK(stroke_decode<double>)->Unit(benchmark::kMillisecond);
+BENCHMARK(stroke_decode<float>)->Unit(benchmark::kMillisecond);
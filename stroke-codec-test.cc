@@ -0,0 +1,123 @@
+
+#include <gtest/gtest.h>
+
+#include "stroke-codec.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+class stroke_codec_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+using point = aux::versor<double, 5>;   // x, y, pressure, tilt x, tilt y
+
+namespace
+{
+    // A pen stroke as the filter emits it: points about 2 px apart along a
+    // wandering curve, pressure and tilt drifting slowly.
+    std::vector<point> pen_stroke(size_t n, unsigned seed = 1) {
+        std::mt19937 gen{seed};
+        std::uniform_real_distribution<double> turn{-0.15, 0.15}, drift{-0.004, 0.004};
+        std::vector<point> ret;
+        double x = 1000, y = 600, heading = 0, pressure = 0.5, tx = 10, ty = -5;
+        for (size_t i = 0; i < n; ++i) {
+            heading += turn(gen);
+            x += 2 * std::cos(heading);
+            y += 2 * std::sin(heading);
+            pressure = std::clamp(pressure + drift(gen), 0.0, 1.0);
+            tx += drift(gen) * 10;
+            ty += drift(gen) * 10;
+            ret.push_back({x, y, pressure, tx, ty});
+        }
+        return ret;
+    }
+}
+
+TEST_F(stroke_codec_test, round_trip) {
+    criss_cross::stroke_codec<5> codec;
+    for (size_t n : {0, 1, 2, 127, 128, 129, 1000}) {
+        auto points = pen_stroke(n);
+        std::vector<uint8_t> bytes;
+        codec.encode(std::span<point const>{points}, bytes);
+        ASSERT_EQ(codec.size(bytes), n);
+        std::vector<point> decoded;
+        ASSERT_EQ(codec.decode(bytes, decoded), bytes.size());
+        ASSERT_EQ(decoded.size(), n);
+        for (size_t i = 0; i < n; ++i) {
+            // within half a step of every channel
+            ASSERT_NEAR(get<0>(decoded[i]), get<0>(points[i]), 0.5 / 64);
+            ASSERT_NEAR(get<1>(decoded[i]), get<1>(points[i]), 0.5 / 64);
+            ASSERT_NEAR(get<2>(decoded[i]), get<2>(points[i]), 0.5 / 4096);
+            ASSERT_NEAR(get<3>(decoded[i]), get<3>(points[i]), 0.5 / 16);
+            ASSERT_EQ(codec.quantize(decoded[i]), codec.quantize(points[i]));
+        }
+    }
+}
+
+TEST_F(stroke_codec_test, ratio) {
+    criss_cross::stroke_codec<5> codec;
+    auto points = pen_stroke(100'000);
+    std::vector<uint8_t> bytes;
+    codec.encode(std::span<point const>{points}, bytes);
+    auto full = points.size() * sizeof (point);
+    // several times smaller than doubles, smaller than floats too
+    ASSERT_GT(static_cast<double>(full) / static_cast<double>(bytes.size()), 6.0);
+    ASSERT_LT(bytes.size(), points.size() * 5 * sizeof (float) / 4);
+}
+
+TEST_F(stroke_codec_test, extremes) {
+    // full-range jumps need 32-bit deltas; out of range values saturate
+    criss_cross::stroke_codec<2>::parameters params;
+    params.fraction_bits = {0, 8};
+    criss_cross::stroke_codec<2> codec{params};
+    std::vector<aux::versor<float, 2>> points{
+        {2147483647.0f, 0.0f}, {-2147483648.0f, -1.0f}, {0.0f, 1e30f}, {1.0f, -1e30f}, {-1.0f, 0.5f},
+    };
+    std::vector<uint8_t> bytes;
+    codec.encode(std::span<aux::versor<float, 2> const>{points}, bytes);
+    std::vector<aux::versor<double, 2>> decoded;
+    codec.decode(bytes, decoded);
+    ASSERT_EQ(decoded.size(), points.size());
+    ASSERT_EQ(get<0>(decoded[0]), 2147483647.0);
+    ASSERT_EQ(get<0>(decoded[1]), -2147483648.0);
+    ASSERT_EQ(get<1>(decoded[1]), -1.0);
+    ASSERT_EQ(get<1>(decoded[2]), 2147483647.0 / 256);
+    ASSERT_EQ(get<1>(decoded[3]), -2147483648.0 / 256);
+    ASSERT_EQ(get<0>(decoded[4]), -1.0);
+    ASSERT_EQ(get<1>(decoded[4]), 0.5);
+}
+
+TEST_F(stroke_codec_test, back_to_back) {
+    criss_cross::stroke_codec<5> codec;
+    auto a = pen_stroke(300, 1);
+    auto b = pen_stroke(50, 2);
+    std::vector<uint8_t> bytes;
+    codec.encode(std::span<point const>{a}, bytes);
+    codec.encode(std::span<point const>{b}, bytes);
+    std::vector<point> decoded;
+    auto used = codec.decode(bytes, decoded);
+    ASSERT_EQ(decoded.size(), 300);
+    used += codec.decode(std::span{bytes}.subspan(used), decoded);
+    ASSERT_EQ(used, bytes.size());
+    ASSERT_EQ(decoded.size(), 350);
+    ASSERT_EQ(codec.quantize(decoded[300]), codec.quantize(b[0]));
+    ASSERT_EQ(codec.quantize(decoded[349]), codec.quantize(b[49]));
+}
+
+TEST_F(stroke_codec_test, malformed) {
+    criss_cross::stroke_codec<5> codec;
+    auto points = pen_stroke(200);
+    std::vector<uint8_t> bytes;
+    codec.encode(std::span<point const>{points}, bytes);
+    std::vector<point> decoded;
+    for (size_t cut : {size_t{0}, size_t{1}, bytes.size() / 2, bytes.size() - 1}) {
+        ASSERT_THROW(codec.decode(std::span{bytes}.first(cut), decoded), std::runtime_error);
+    }
+    std::vector<uint8_t> huge{0xff, 0xff, 0xff, 0xff, 0x0f};
+    ASSERT_THROW(codec.decode(huge, decoded), std::runtime_error);
+}
@@ -0,0 +1,260 @@
+#ifndef INCLUDE_STROKE_CODEC_HPP
+#define INCLUDE_STROKE_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <array>
+#include <span>
+#include <bit>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <aux/versor.hpp>
+
+namespace criss_cross
+{
+    // Compact stroke encoding.  Every channel (x, y, pressure, tilt, ...)
+    // is quantized to a fixed-point integer with a per-channel number of
+    // fraction bits, consecutive samples are delta coded, and the zigzagged
+    // deltas are bit-packed a block of up to 128 points at a time, at the
+    // smallest width that holds the largest delta of the block in that
+    // channel.  A stroke is:
+    //
+    //   varint  point count
+    //   blocks, each for every channel:
+    //     varint  zigzag(first value - last value of the previous block)
+    //     byte    width w, 0..32
+    //     bytes   (points - 1) deltas of w bits, LSB first, byte padded
+    //
+    // Decoding works a block column at a time, with branch-free loops over
+    // fixed-size arrays: unpack at a width fixed per instance, prefix sum,
+    // then scale into the points.
+    // Strokes may be stored back to back; decode() reports where one ends.
+    template <size_t N>
+    class stroke_codec {
+    public:
+        using quantized = aux::versor<int32_t, N>;
+        constexpr static size_t block_size = 128;
+
+        struct parameters {
+            // fixed-point fraction bits per channel; the defaults suit
+            // x, y in pixels, pressure in [0, 1], then tilt in degrees
+            std::array<int, N> fraction_bits = [] {
+                std::array<int, N> ret;
+                for (size_t c = 0; c < N; ++c) ret[c] = c < 2 ? 6 : c == 2 ? 12 : 4;
+                return ret;
+            }();
+        };
+
+    public:
+        explicit stroke_codec(parameters params = {}) noexcept
+            : params{params}
+        {
+            for (size_t c = 0; c < N; ++c) {
+                scale[c] = std::ldexp(1.0, params.fraction_bits[c]);
+                step[c] = std::ldexp(1.0, -params.fraction_bits[c]);
+            }
+        }
+
+    public:
+        parameters const& get_parameters() const noexcept { return params; }
+
+        // Nearest fixed-point value, saturated to the int32 range.
+        template <class T>
+        quantized quantize(aux::versor<T, N> const& p) const noexcept {
+            quantized ret;
+            for (size_t c = 0; c < N; ++c) {
+                auto q = std::nearbyint(static_cast<double>(p[c]) * scale[c]);
+                if (std::isnan(q)) q = 0;
+                ret[c] = static_cast<int32_t>(std::clamp(q, -2147483648.0, 2147483647.0));
+            }
+            return ret;
+        }
+        template <class T>
+        aux::versor<T, N> dequantize(quantized const& q) const noexcept {
+            aux::versor<T, N> ret;
+            for (size_t c = 0; c < N; ++c) ret[c] = static_cast<T>(q[c] * step[c]);
+            return ret;
+        }
+
+        // Appends the encoding of points to out.
+        template <class T>
+        void encode(std::span<aux::versor<T, N> const> points, std::vector<uint8_t>& out) const {
+            put_varint(out, points.size());
+            std::array<uint32_t, N> last{};
+            std::array<uint32_t, block_size> deltas;
+            for (size_t first = 0; first < points.size(); first += block_size) {
+                auto count = std::min(block_size, points.size() - first);
+                std::array<quantized, block_size> block;
+                for (size_t i = 0; i < count; ++i) block[i] = quantize(points[first + i]);
+                for (size_t c = 0; c < N; ++c) {
+                    auto prev = static_cast<uint32_t>(block[0][c]);
+                    put_varint(out, zigzag(prev - last[c]));
+                    uint32_t any = 0;
+                    for (size_t i = 1; i < count; ++i) {
+                        auto v = static_cast<uint32_t>(block[i][c]);
+                        deltas[i - 1] = zigzag(v - prev);
+                        any |= deltas[i - 1];
+                        prev = v;
+                    }
+                    last[c] = prev;
+                    auto width = static_cast<unsigned>(std::bit_width(any));
+                    out.push_back(static_cast<uint8_t>(width));
+                    pack(std::span{deltas}.first(count - 1), width, out);
+                }
+            }
+        }
+
+        // Decodes the stroke at the start of in into the first size(in)
+        // elements of out and returns the bytes it took.  Throws
+        // std::runtime_error on a truncated or malformed stroke or when out
+        // is too small.
+        template <class T>
+        size_t decode(std::span<uint8_t const> in, std::span<aux::versor<T, N>> out) const {
+            size_t pos = 0;
+            auto total = get_varint(in, pos);
+            if (total > out.size()) throw std::runtime_error("stroke_codec: output too small");
+            std::array<uint32_t, N> last{};
+            alignas (64) std::array<std::array<uint32_t, block_size>, N> columns;
+            for (size_t first = 0; first < total; first += block_size) {
+                auto count = std::min(block_size, total - first);
+                for (size_t c = 0; c < N; ++c) {
+                    auto& col = columns[c];
+                    col[0] = last[c] + unzigzag(static_cast<uint32_t>(get_varint(in, pos)));
+                    if (pos >= in.size()) throw std::runtime_error("stroke_codec: truncated");
+                    auto width = in[pos++];
+                    if (width > 32) throw std::runtime_error("stroke_codec: bad width");
+                    auto bytes = (static_cast<size_t>(width) * (count - 1) + 7) / 8;
+                    if (in.size() - pos < bytes) throw std::runtime_error("stroke_codec: truncated");
+                    unpack(in.subspan(pos, bytes), width, std::span{col}.subspan(1, count - 1));
+                    pos += bytes;
+                    // zigzag deltas -> values
+                    auto v = col[0];
+                    for (size_t i = 1; i < count; ++i) col[i] = v += unzigzag(col[i]);
+                    last[c] = v;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    auto& p = out[first + i];
+                    for (size_t c = 0; c < N; ++c) {
+                        p[c] = static_cast<T>(static_cast<int32_t>(columns[c][i]) * step[c]);
+                    }
+                }
+            }
+            return pos;
+        }
+
+        // Appends the points of the stroke at the start of in to out and
+        // returns the bytes it took; on error out is left as it was.
+        template <class T>
+        size_t decode(std::span<uint8_t const> in, std::vector<aux::versor<T, N>>& out) const {
+            auto total = size(in);
+            // a block takes at least two bytes a channel
+            if (total > in.size() * block_size) throw std::runtime_error("stroke_codec: bad point count");
+            auto base = out.size();
+            out.resize(base + total);
+            try {
+                return decode(in, std::span{out}.subspan(base));
+            }
+            catch (...) {
+                out.resize(base);
+                throw;
+            }
+        }
+
+        // Point count of the stroke at the start of in.
+        static size_t size(std::span<uint8_t const> in) {
+            size_t pos = 0;
+            return get_varint(in, pos);
+        }
+
+    private:
+        static uint32_t zigzag(uint32_t d) noexcept {
+            return (d << 1) ^ static_cast<uint32_t>(-(d >> 31));
+        }
+        static uint32_t unzigzag(uint32_t z) noexcept {
+            return (z >> 1) ^ static_cast<uint32_t>(-(z & 1));
+        }
+
+        static void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(v));
+        }
+        static uint64_t get_varint(std::span<uint8_t const> in, size_t& pos) {
+            uint64_t ret = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (pos >= in.size()) throw std::runtime_error("stroke_codec: truncated");
+                auto b = in[pos++];
+                ret |= static_cast<uint64_t>(b & 0x7f) << shift;
+                if (!(b & 0x80)) return ret;
+            }
+            throw std::runtime_error("stroke_codec: bad varint");
+        }
+
+        static void pack(std::span<uint32_t const> values, unsigned width, std::vector<uint8_t>& out) {
+            if (width == 0) return;
+            uint64_t acc = 0;
+            unsigned bits = 0;
+            for (auto v : values) {
+                acc |= static_cast<uint64_t>(v) << bits;
+                bits += width;
+                while (bits >= 8) {
+                    out.push_back(static_cast<uint8_t>(acc));
+                    acc >>= 8;
+                    bits -= 8;
+                }
+            }
+            if (bits) out.push_back(static_cast<uint8_t>(acc));
+        }
+
+        // Value i sits at bit i * width; an unaligned 8-byte load at its
+        // byte holds all of it (width + 7 <= 39 bits).  Values within the
+        // last 8 bytes are read from a zero-padded copy of the tail rather
+        // than past the end of in.  Each width has its own instance, so
+        // shifts and masks are constants.
+        template <unsigned Width>
+        static void unpack(std::span<uint8_t const> in, std::span<uint32_t> values) noexcept {
+            if constexpr (Width == 0) {
+                std::fill(values.begin(), values.end(), 0u);
+            }
+            else {
+                constexpr auto mask = (uint64_t{1} << Width) - 1;
+                auto extract = [](uint8_t const* src, size_t bit) {
+                    uint64_t word;
+                    std::memcpy(&word, src + bit / 8, sizeof word);
+                    return static_cast<uint32_t>((word >> (bit % 8)) & mask);
+                };
+                size_t fast = in.size() >= 8 ? std::min(values.size(), (in.size() - 8) * 8 / Width + 1) : 0;
+                for (size_t i = 0; i < fast; ++i) values[i] = extract(in.data(), i * Width);
+                if (fast < values.size()) {
+                    auto from = fast * Width / 8;
+                    std::array<uint8_t, 16> tail{};
+                    std::copy(in.begin() + static_cast<ptrdiff_t>(from), in.end(), tail.begin());
+                    for (size_t i = fast; i < values.size(); ++i) {
+                        values[i] = extract(tail.data(), i * Width - from * 8);
+                    }
+                }
+            }
+        }
+        static void unpack(std::span<uint8_t const> in, unsigned width, std::span<uint32_t> values) noexcept {
+            using function = void (*)(std::span<uint8_t const>, std::span<uint32_t>) noexcept;
+            constexpr auto table = []<unsigned... W>(std::integer_sequence<unsigned, W...>) {
+                return std::array<function, sizeof... (W)>{&unpack<W>...};
+            }(std::make_integer_sequence<unsigned, 33>{});
+            table[width](in, values);
+        }
+
+    private:
+        parameters params;
+        std::array<double, N> scale;
+        std::array<double, N> step;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_STROKE_CODEC_HPP
@@ -0,0 +1,106 @@
+
+#include <gtest/gtest.h>
+
+#include "stroke-filter.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+class stroke_filter_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+namespace
+{
+    using filter = criss_cross::stroke_filter<3>;
+    using sample = filter::sample;
+
+    // A pen moving right at 200 px/s, sampled at 200 Hz, with optional
+    // jitter on y.
+    void line(size_t n, float jitter, std::vector<sample>& samples, std::vector<uint32_t>& times) {
+        std::mt19937 gen{3};
+        std::normal_distribution<float> noise{0.0f, jitter};
+        for (size_t i = 0; i < n; ++i) {
+            samples.push_back({static_cast<float>(i), jitter > 0 ? noise(gen) : 0.0f, 0.5f});
+            times.push_back(static_cast<uint32_t>(i * 5));
+        }
+    }
+
+    std::vector<sample> run(filter& f, std::vector<sample> const& samples, std::vector<uint32_t> const& times, size_t batch) {
+        std::vector<sample> out;
+        for (size_t i = 0; i < samples.size(); i += batch) {
+            auto n = std::min(batch, samples.size() - i);
+            f.push(std::span{samples}.subspan(i, n), std::span{times}.subspan(i, n), out);
+        }
+        f.finish(out);
+        return out;
+    }
+} // namespace
+
+TEST_F(stroke_filter_test, at_rest) {
+    filter f;
+    std::vector<sample> samples(50, sample{10.0f, 20.0f, 0.3f});
+    std::vector<uint32_t> times(50);
+    for (size_t i = 0; i < times.size(); ++i) times[i] = static_cast<uint32_t>(i * 5);
+    auto out = run(f, samples, times, 8);
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(out[0], samples[0]);
+}
+
+TEST_F(stroke_filter_test, spacing) {
+    filter f{{.spacing = 3.0f}};
+    std::vector<sample> samples;
+    std::vector<uint32_t> times;
+    line(200, 0, samples, times);
+    auto out = run(f, samples, times, 16);
+    ASSERT_GT(out.size(), 50u);
+    ASSERT_EQ(out.front(), samples.front());
+    for (size_t i = 1; i + 1 < out.size(); ++i) {
+        ASSERT_NEAR(get<0>(out[i]) - get<0>(out[i - 1]), 3.0f, 0.05f) << i;
+        ASSERT_NEAR(get<1>(out[i]), 0.0f, 1e-4f);
+        ASSERT_NEAR(get<2>(out[i]), 0.5f, 1e-4f);
+    }
+    ASSERT_LE(get<0>(out.back()) - get<0>(out[out.size() - 2]), 3.0f + 0.05f);
+}
+
+TEST_F(stroke_filter_test, degenerate_spacing) {
+    std::vector<sample> samples;
+    std::vector<uint32_t> times;
+    line(20, 0, samples, times);
+    for (float spacing : {0.0f, -1.0f, std::nanf("")}) {
+        filter f{{.spacing = spacing}};
+        auto out = run(f, samples, times, 8);
+        // clamped to min_spacing
+        ASSERT_GT(out.size(), 2u);
+        auto length = get<0>(out.back()) - get<0>(out.front());
+        ASSERT_NEAR(static_cast<float>(out.size() - 1), length / filter::min_spacing, 1.0f) << spacing;
+    }
+}
+
+TEST_F(stroke_filter_test, batching) {
+    std::vector<sample> samples;
+    std::vector<uint32_t> times;
+    line(300, 1.0f, samples, times);
+    filter f;
+    auto expected = run(f, samples, times, samples.size());
+    for (size_t batch : {1, 2, 7, 64}) {
+        ASSERT_EQ(run(f, samples, times, batch), expected) << batch;
+    }
+}
+
+TEST_F(stroke_filter_test, jitter) {
+    std::vector<sample> samples;
+    std::vector<uint32_t> times;
+    line(400, 1.5f, samples, times);
+    filter f{{.spacing = 1.0f}};
+    auto out = run(f, samples, times, 32);
+    auto rms = [](std::vector<sample> const& v) {
+        double sum = 0;
+        for (auto const& s : v) sum += get<1>(s) * get<1>(s);
+        return std::sqrt(sum / static_cast<double>(v.size()));
+    };
+    ASSERT_LT(rms(out), rms(samples) * 0.5);
+}
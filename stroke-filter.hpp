@@ -0,0 +1,185 @@
+#ifndef INCLUDE_STROKE_FILTER_HPP
+#define INCLUDE_STROKE_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <span>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+#include <aux/versor.hpp>
+
+namespace criss_cross
+{
+    // Streaming pen smoothing: raw samples (x, y, then any further
+    // channels such as pressure and tilt) go through a 1-euro filter, the
+    // filtered points are joined by a uniform Catmull-Rom spline, and
+    // points spaced evenly by arc length in x, y are emitted along it.
+    //
+    // Each push() continues where the previous one stopped; the state is a
+    // fixed window of four spline points, so nothing is re-processed and
+    // nothing is allocated once the output vector has grown.  The filter
+    // recurrence is serial in time; it is evaluated for all channels at
+    // once with versor arithmetic, as is the spline.  Output runs one raw
+    // sample behind the input until finish().
+    template <size_t N>
+    class stroke_filter {
+        static_assert(N >= 2);
+
+    public:
+        using sample = aux::versor<float, N>;
+
+        constexpr static float min_spacing = 1.0f / 64;
+
+        struct parameters {
+            float spacing = 2.0f;             // output point distance, pixels, >= min_spacing
+            float min_cutoff = 1.0f;          // Hz, at rest
+            float beta = 0.01f;               // cutoff gain per unit/s of speed
+            float derivative_cutoff = 1.0f;   // Hz
+            float rate = 200.0f;              // assumed when timestamps repeat
+        };
+
+    public:
+        explicit stroke_filter(parameters params = {}) noexcept
+            : params{params}
+        {
+            // a spacing of zero (or NaN) would emit points forever
+            if (!(this->params.spacing >= min_spacing)) this->params.spacing = min_spacing;
+        }
+
+    public:
+        // Forgets the current stroke; the next sample starts a new one.
+        void reset() noexcept {
+            filtered = 0;
+            points = 0;
+            pending = 0;
+        }
+
+        // Filters one batch, samples[i] taken at times[i] (milliseconds,
+        // as the tablet reports them), and appends the points it completes
+        // to out.  Returns how many were appended.
+        size_t push(std::span<sample const> samples, std::span<uint32_t const> times, std::vector<sample>& out) {
+            auto size = out.size();
+            for (size_t i = 0; i < samples.size() && i < times.size(); ++i) {
+                add(smooth(samples[i], times[i]), out);
+            }
+            return out.size() - size;
+        }
+
+        // Ends the stroke: emits the rest of the curve up to the last
+        // filtered point, then resets.
+        size_t finish(std::vector<sample>& out) {
+            auto size = out.size();
+            if (points > 1) {
+                // the final span has no successor; repeat its end point
+                window[3] = window[2];
+                span(out);
+                if (pending < params.spacing) out.push_back(window[2]);
+            }
+            reset();
+            return out.size() - size;
+        }
+
+    private:
+        // 1-euro: a low pass whose cutoff rises with the filtered speed,
+        // per channel.
+        sample smooth(sample const& x, uint32_t time) noexcept {
+            if (filtered++ == 0) {
+                value = x;
+                slope = sample{};
+                last_time = time;
+                return x;
+            }
+            auto dt = time > last_time ? static_cast<float>(time - last_time) * 0.001f : 1.0f / params.rate;
+            last_time = time;
+            sample raw_slope = (x - value) * (1.0f / dt);
+            slope += (raw_slope - slope) * alpha(params.derivative_cutoff, dt);
+            sample speed = max(slope, -slope);
+            sample cutoff = speed * params.beta + uniform(params.min_cutoff);
+            sample r = cutoff * (2 * std::numbers::pi_v<float> * dt);
+            sample a = r / (r + uniform(1.0f));
+            value += (x - value) * a;
+            return value;
+        }
+
+        static float alpha(float cutoff, float dt) noexcept {
+            auto r = 2 * std::numbers::pi_v<float> * cutoff * dt;
+            return r / (r + 1);
+        }
+        static sample uniform(float s) noexcept {
+            sample ret;
+            for (auto& x : ret) x = s;
+            return ret;
+        }
+
+        // Slides the spline window; the span window[1] -> window[2] is
+        // drawn once window[3] is known.
+        void add(sample const& p, std::vector<sample>& out) {
+            if (points == 0) {
+                window[0] = window[1] = window[2] = p;
+                points = 1;
+                pending = params.spacing;
+                out.push_back(p);
+                return;
+            }
+            if (points == 1) {
+                window[2] = p;
+                points = 2;
+                return;
+            }
+            window[3] = p;
+            span(out);
+            window[0] = window[1];
+            window[1] = window[2];
+            window[2] = window[3];
+        }
+
+        // Walks window[1] -> window[2] in fixed parameter steps, emitting a
+        // point every spacing of chord length; pending carries the distance
+        // still owed from the previous span.
+        void span(std::vector<sample>& out) {
+            auto const& p0 = window[0];
+            auto const& p1 = window[1];
+            auto const& p2 = window[2];
+            auto const& p3 = window[3];
+            sample c1 = (p2 - p0) * 0.5f;
+            sample c2 = (p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3) * 0.5f;
+            sample c3 = (p1 * 3.0f - p0 - p2 * 3.0f + p3) * 0.5f;
+            auto at = [&](float t) -> sample { return p1 + (c1 + (c2 + c3 * t) * t) * t; };
+
+            constexpr int steps = 8;
+            sample a = p1;
+            float ta = 0;
+            for (int k = 1; k <= steps; ++k) {
+                float tb = static_cast<float>(k) / steps;
+                sample b = at(tb);
+                float dx = get<0>(b) - get<0>(a);
+                float dy = get<1>(b) - get<1>(a);
+                float length = std::sqrt(dx * dx + dy * dy);
+                float walked = 0;
+                while (pending <= length - walked) {
+                    walked += pending;
+                    out.push_back(at(ta + (tb - ta) * (length > 0 ? walked / length : 0)));
+                    pending = params.spacing;
+                }
+                pending -= length - walked;
+                a = b;
+                ta = tb;
+            }
+        }
+
+    private:
+        parameters params;
+        size_t filtered = 0;
+        sample value;
+        sample slope;
+        uint32_t last_time = 0;
+        sample window[4];
+        size_t points = 0;
+        float pending = 0;   // arc length left before the next output point
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_STROKE_FILTER_HPP
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include "stroke-store.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    using store = criss_cross::stroke_store<3>;
+    using point = store::point;
+
+    // A document of 10^6 points: 4000 strokes of 250.
+    store const& document() {
+        static auto const ret = [] {
+            store s;
+            std::vector<point> p(250);
+            for (size_t k = 0; k < 4000; ++k) {
+                for (size_t i = 0; i < p.size(); ++i) {
+                    auto t = static_cast<float>(i);
+                    p[i] = {static_cast<float>(k % 64) * 60 + t * 0.2f, static_cast<float>(k / 64) * 35 + 10 * std::sin(t * 0.1f), 0.5f};
+                }
+                s.add(p, 0xff202020u);
+            }
+            return s;
+        }();
+        return ret;
+    }
+
+    void stroke_store_snapshot(benchmark::State& state) {
+        auto const& doc = document();
+        for (auto _ : state) {
+            store copy = doc;
+            benchmark::DoNotOptimize(copy);
+        }
+    }
+
+    // Commit, move one stroke, undo: what an edit plus its undo cost.
+    void stroke_store_edit_undo(benchmark::State& state) {
+        criss_cross::revision_history<store> history{document()};
+        size_t k = 0;
+        for (auto _ : state) {
+            history.commit();
+            history.current().transform(k++ * 7919 % 4000, [](point& p) { p += point{1.0f, 1.0f, 0.0f}; });
+            history.undo();
+        }
+    }
+
+    void stroke_store_undo_redo(benchmark::State& state) {
+        criss_cross::revision_history<store> history{document()};
+        history.commit();
+        history.current().transform(1234, [](point& p) { p += point{1.0f, 1.0f, 0.0f}; });
+        for (auto _ : state) {
+            history.undo();
+            history.redo();
+        }
+    }
+
+    // A new 250-point stroke on a shared document, as drawing one would.
+    void stroke_store_add_undo(benchmark::State& state) {
+        criss_cross::revision_history<store> history{document()};
+        std::vector<point> p(250, point{100.0f, 100.0f, 0.5f});
+        for (auto _ : state) {
+            history.commit();
+            history.current().add(p, 0xff202020u);
+            history.undo();
+        }
+    }
+
+    // Memory of 100 revisions, each moving one stroke, against the
+    // document alone.
+    void stroke_store_revision_memory(benchmark::State& state) {
+        size_t base = 0, total = 0;
+        for (auto _ : state) {
+            criss_cross::revision_history<store> history{document()};
+            base = history.memory();
+            for (size_t k = 0; k < 100; ++k) {
+                history.commit();
+                history.current().transform(k * 7919 % 4000, [](point& p) { p += point{1.0f, 0.0f, 0.0f}; });
+            }
+            total = history.memory();
+        }
+        state.counters["document_bytes"] = static_cast<double>(base);
+        state.counters["bytes_per_revision"] = static_cast<double>(total - base) / 100;
+    }
+}
+
+BENCHMARK(stroke_store_snapshot);
+BENCHMARK(stroke_store_edit_undo);
+BENCHMARK(stroke_store_undo_redo);
+BENCHMARK(stroke_store_add_undo);
+BENCHMARK(stroke_store_revision_memory)->Unit(benchmark::kMillisecond);
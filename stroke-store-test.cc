@@ -0,0 +1,84 @@
+
+#include <gtest/gtest.h>
+
+#include "stroke-store.hpp"
+
+#include <vector>
+
+class stroke_store_test : public testing::Test {
+protected:
+    void SetUp() override { }
+    void TearDown() override {}
+};
+
+using store = criss_cross::stroke_store<3>;
+using point = store::point;
+
+namespace
+{
+    std::vector<point> line(size_t n, float y) {
+        std::vector<point> ret;
+        for (size_t i = 0; i < n; ++i) ret.push_back({static_cast<float>(i) * 2.0f, y, 0.5f});
+        return ret;
+    }
+}
+
+TEST_F(stroke_store_test, strokes) {
+    store s;
+    auto a = line(300, 10.0f);
+    auto b = line(5, 20.0f);
+    ASSERT_EQ(s.add(a, 0xff000000u), 0);
+    ASSERT_EQ(s.add(b, 0xffff0000u), 1);
+    ASSERT_EQ(s.strokes(), 2);
+    ASSERT_EQ(s.points(), 305);
+    ASSERT_EQ(s.stroke(1).first, 300);
+    ASSERT_EQ(s.stroke(1).count, 5);
+    ASSERT_EQ(get<1>(s[300]), 20.0f);
+
+    s.extend(line(3, 20.0f));
+    ASSERT_EQ(s.stroke(1).count, 8);
+    std::vector<point> got;
+    s.for_each_span(0, [&](std::span<point const> p) { got.insert(got.end(), p.begin(), p.end()); });
+    ASSERT_EQ(got, a);
+
+    s.erase(0);
+    ASSERT_TRUE(s.stroke(0).erased);
+    ASSERT_FALSE(s.stroke(1).erased);
+    ASSERT_THROW(s.erase(2), std::out_of_range);
+}
+
+TEST_F(stroke_store_test, undo_redo) {
+    criss_cross::revision_history<store> history;
+    for (int i = 0; i < 100; ++i) {
+        history.commit();
+        history.current().add(line(1000, static_cast<float>(i)), 0xff000000u);
+    }
+    auto full = history.memory();
+
+    // moving a stroke clones only its chunks
+    history.commit();
+    history.current().transform(50, [](point& p) { p += point{0.0f, 100.0f, 0.0f}; });
+    ASSERT_EQ(get<1>(history.current()[50 * 1000]), 150.0f);
+    auto moved = history.memory();
+    ASSERT_LT(moved - full, full / 20);
+
+    history.commit();
+    history.current().erase(10);
+
+    ASSERT_TRUE(history.undo());
+    ASSERT_FALSE(history.current().stroke(10).erased);
+    ASSERT_TRUE(history.undo());
+    ASSERT_EQ(get<1>(history.current()[50 * 1000]), 50.0f);
+    ASSERT_EQ(history.redo_depth(), 2);
+    ASSERT_TRUE(history.redo());
+    ASSERT_EQ(get<1>(history.current()[50 * 1000]), 150.0f);
+
+    // a new edit drops the redo list
+    history.commit();
+    history.current().recolor(0, 0xff00ff00u);
+    ASSERT_EQ(history.redo_depth(), 0);
+    ASSERT_FALSE(history.redo());
+
+    while (history.undo()) continue;
+    ASSERT_EQ(history.current().strokes(), 0);
+}
@@ -0,0 +1,145 @@
+#ifndef INCLUDE_STROKE_STORE_HPP
+#define INCLUDE_STROKE_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <aux/versor.hpp>
+#include <aux/persistent-vector.hpp>
+
+namespace criss_cross
+{
+    // The strokes of a document: one sequence of points (x, y, then any
+    // further channels such as pressure) holding every stroke back to
+    // back, and a table of strokes indexing it.  Both are persistent
+    // vectors, so a stroke_store is a value: copying it is a snapshot in
+    // O(1), and an edit of the copy clones only the chunks it touches.
+    // Erasing a stroke only marks it; its points stay for the revisions
+    // that still show it.
+    template <size_t N>
+    class stroke_store {
+    public:
+        using point = aux::versor<float, N>;
+
+        struct stroke_record {
+            uint64_t first;   // into the points
+            uint32_t count;
+            uint32_t color;   // ARGB
+            bool erased;
+        };
+
+    public:
+        size_t strokes() const noexcept { return table.size(); }          // erased ones included
+        size_t points() const noexcept { return samples.size(); }
+        stroke_record const& stroke(size_t id) const { return table.at(id); }
+        point const& operator[](size_t i) const noexcept { return samples[i]; }
+
+        // Adds a stroke and returns its id.
+        size_t add(std::span<point const> p, uint32_t color) {
+            table.push_back({samples.size(), static_cast<uint32_t>(p.size()), color, false});
+            samples.append(p);
+            return table.size() - 1;
+        }
+
+        // Appends to the last stroke, as points arrive while it is drawn.
+        void extend(std::span<point const> p) {
+            if (table.empty()) throw std::logic_error("stroke_store::extend: no stroke");
+            auto& r = table.mutable_at(table.size() - 1);
+            r.count += static_cast<uint32_t>(p.size());
+            samples.append(p);
+        }
+
+        void erase(size_t id) {
+            if (id >= table.size()) throw std::out_of_range("stroke_store::erase");
+            table.mutable_at(id).erased = true;
+        }
+        void recolor(size_t id, uint32_t color) {
+            if (id >= table.size()) throw std::out_of_range("stroke_store::recolor");
+            table.mutable_at(id).color = color;
+        }
+
+        // Calls func(point&) for every point of stroke id (a move, say).
+        template <class Func>
+        void transform(size_t id, Func&& func) {
+            auto const& r = table.at(id);
+            samples.modify(r.first, r.first + r.count, [&](std::span<point> piece) {
+                for (auto& p : piece) func(p);
+            });
+        }
+
+        // Calls func(span) for the contiguous pieces of stroke id's points.
+        template <class Func>
+        void for_each_span(size_t id, Func&& func) const {
+            auto const& r = table.at(id);
+            samples.for_each_span(r.first, r.first + r.count, std::forward<Func>(func));
+        }
+
+        // Bytes of storage not in seen; see aux::persistent_vector::memory.
+        size_t memory(std::unordered_set<void const*>& seen) const {
+            return samples.memory(seen) + table.memory(seen);
+        }
+
+    private:
+        aux::persistent_vector<point> samples;
+        aux::persistent_vector<stroke_record, 64> table;
+    };
+
+    // Undo and redo over snapshots of a store.  Call commit() before each
+    // edit of current(); undo() and redo() swap whole revisions in O(1).
+    template <class Store>
+    class revision_history {
+    public:
+        explicit revision_history(Store initial = {})
+            : head{std::move(initial)}
+        {
+        }
+
+    public:
+        Store& current() noexcept { return head; }
+        Store const& current() const noexcept { return head; }
+        size_t undo_depth() const noexcept { return past.size(); }
+        size_t redo_depth() const noexcept { return future.size(); }
+
+        // Records the current revision; the redo list is dropped.
+        void commit() {
+            past.push_back(head);
+            future.clear();
+        }
+
+        bool undo() {
+            if (past.empty()) return false;
+            future.push_back(std::move(head));
+            head = std::move(past.back());
+            past.pop_back();
+            return true;
+        }
+        bool redo() {
+            if (future.empty()) return false;
+            past.push_back(std::move(head));
+            head = std::move(future.back());
+            future.pop_back();
+            return true;
+        }
+
+        // Bytes held by all revisions together, shared storage once.
+        size_t memory() const {
+            std::unordered_set<void const*> seen;
+            auto ret = head.memory(seen);
+            for (auto const& s : past) ret += s.memory(seen);
+            for (auto const& s : future) ret += s.memory(seen);
+            return ret;
+        }
+
+    private:
+        Store head;
+        std::vector<Store> past;
+        std::vector<Store> future;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_STROKE_STORE_HPP
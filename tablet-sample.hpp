@@ -0,0 +1,34 @@
+#ifndef INCLUDE_TABLET_SAMPLE_HPP
+#define INCLUDE_TABLET_SAMPLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <aux/packed-tuple.hpp>
+
+namespace criss_cross
+{
+    // One pen sample, emitted on every zwp_tablet_tool_v2.frame:
+    // time (ms), tool, state bits, surface x, y, pressure [0, 1], tilt x, y (degrees).
+    using tablet_sample = aux::packed_tuple<uint32_t, uint16_t, uint8_t, float, float, float, float, float>;
+    static_assert(sizeof (tablet_sample) == 27);
+
+    enum tablet_field : size_t {
+        sample_time,
+        sample_tool,
+        sample_state,
+        sample_x,
+        sample_y,
+        sample_pressure,
+        sample_tilt_x,
+        sample_tilt_y,
+    };
+
+    enum tablet_state : uint8_t {
+        tablet_proximity = 0x01,
+        tablet_down      = 0x02,
+        tablet_eraser    = 0x04,
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_TABLET_SAMPLE_HPP
@@ -0,0 +1,215 @@
+#ifndef INCLUDE_TABLET_HPP
+#define INCLUDE_TABLET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <array>
+#include <span>
+#include <list>
+#include <thread>
+#include <functional>
+#include <stop_token>
+
+#include <wayland-client.h>
+#include <zwp-tablet-v2-client.h>
+
+#include <aux/spsc-ring.hpp>
+
+#include "tablet-sample.hpp"
+#include "trace.hpp"
+
+namespace criss_cross
+{
+    // Decodes the tools of one seat on the Wayland dispatch thread and hands
+    // the samples to a processing thread through a wait-free ring.  The
+    // dispatch side never blocks: when the processing thread falls behind,
+    // samples are dropped and counted.  Given an event queue, the seat and
+    // its tools live on it (an event_loop's input queue, dispatched on a
+    // thread of its own) instead of the default queue.
+    class tablet_input {
+    public:
+        using ring_type = aux::spsc_ring<tablet_sample, 4096>;
+        using batch_handler = std::function<void(std::span<tablet_sample const>)>;
+        constexpr static size_t batch_size = 256;
+
+    public:
+        tablet_input(zwp_tablet_manager_v2* manager, wl_seat* wseat, batch_handler handler,
+                     wl_event_queue* queue = nullptr)
+            : seat{get_seat(manager, wseat, queue)}
+            , handler{std::move(handler)}
+            , worker{[this](std::stop_token stop) { process(stop); }}
+        {
+            zwp_tablet_seat_v2_add_listener(this->seat, &seat_listener, this);
+        }
+        tablet_input(tablet_input const&) = delete;
+        tablet_input& operator=(tablet_input const&) = delete;
+
+        ~tablet_input() {
+            worker.request_stop();
+            wake();
+            worker.join();
+            for (auto& t : tools) {
+                zwp_tablet_tool_v2_destroy(t.proxy);
+            }
+            zwp_tablet_seat_v2_destroy(seat);
+        }
+
+    public:
+        size_t pushed() const noexcept { return ring.pushed(); }
+        size_t dropped() const noexcept { return ring.dropped(); }
+        size_t high_water() const noexcept { return ring.high_water(); }
+        size_t processed() const noexcept { return processed_count.load(std::memory_order_relaxed); }
+
+    private:
+        // Creating the seat through a wrapper puts it on queue from the
+        // start; the tools it announces inherit the queue.
+        static zwp_tablet_seat_v2* get_seat(zwp_tablet_manager_v2* manager, wl_seat* wseat, wl_event_queue* queue) {
+            if (!queue) return zwp_tablet_manager_v2_get_tablet_seat(manager, wseat);
+            auto wrapper = static_cast<zwp_tablet_manager_v2*>(wl_proxy_create_wrapper(manager));
+            wl_proxy_set_queue(reinterpret_cast<wl_proxy*>(wrapper), queue);
+            auto ret = zwp_tablet_manager_v2_get_tablet_seat(wrapper, wseat);
+            wl_proxy_wrapper_destroy(wrapper);
+            return ret;
+        }
+
+        struct tool_state {
+            tablet_input* input;
+            zwp_tablet_tool_v2* proxy;
+            uint16_t id;
+            uint8_t state = 0;
+            float x = 0, y = 0;
+            float pressure = 0;
+            float tilt_x = 0, tilt_y = 0;
+        };
+
+        void push(tool_state const& t, uint32_t time) noexcept {
+            ring.try_push(tablet_sample{time, t.id, t.state, t.x, t.y, t.pressure, t.tilt_x, t.tilt_y});
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+        void wake() noexcept {
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+
+        void process(std::stop_token stop) {
+            CRISS_CROSS_TRACE_THREAD("tablet");
+            std::array<tablet_sample, batch_size> batch;
+            while (!stop.stop_requested()) {
+                auto seen = signal.load(std::memory_order_acquire);
+                auto n = ring.drain(batch);
+                if (n == 0) {
+                    signal.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+                CRISS_CROSS_TRACE_SCOPE("tablet.batch", n);
+                handler(std::span<tablet_sample const>{batch.data(), n});
+                processed_count.fetch_add(n, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        // zwp_tablet_seat_v2
+        static void tablet_added(void*, zwp_tablet_seat_v2*, zwp_tablet_v2* tablet) {
+            zwp_tablet_v2_destroy(tablet);
+        }
+        static void tool_added(void* data, zwp_tablet_seat_v2*, zwp_tablet_tool_v2* tool) {
+            auto self = static_cast<tablet_input*>(data);
+            auto& t = self->tools.emplace_back(self, tool, self->next_tool++);
+            zwp_tablet_tool_v2_add_listener(tool, &tool_listener, &t);
+        }
+        static void pad_added(void*, zwp_tablet_seat_v2*, zwp_tablet_pad_v2* pad) {
+            zwp_tablet_pad_v2_destroy(pad);
+        }
+
+        // zwp_tablet_tool_v2
+        static void type(void* data, zwp_tablet_tool_v2*, uint32_t tool_type) {
+            auto t = static_cast<tool_state*>(data);
+            if (tool_type == ZWP_TABLET_TOOL_V2_TYPE_ERASER) t->state |= tablet_eraser;
+        }
+        static void hardware_serial(void*, zwp_tablet_tool_v2*, uint32_t, uint32_t) { }
+        static void hardware_id_wacom(void*, zwp_tablet_tool_v2*, uint32_t, uint32_t) { }
+        static void capability(void*, zwp_tablet_tool_v2*, uint32_t) { }
+        static void done(void*, zwp_tablet_tool_v2*) { }
+        static void removed(void* data, zwp_tablet_tool_v2* tool) {
+            auto t = static_cast<tool_state*>(data);
+            zwp_tablet_tool_v2_destroy(tool);
+            t->input->tools.remove_if([t](auto const& s) { return &s == t; });
+        }
+        static void proximity_in(void* data, zwp_tablet_tool_v2*, uint32_t, zwp_tablet_v2*, wl_surface*) {
+            static_cast<tool_state*>(data)->state |= tablet_proximity;
+        }
+        static void proximity_out(void* data, zwp_tablet_tool_v2*) {
+            static_cast<tool_state*>(data)->state &= ~(tablet_proximity | tablet_down);
+        }
+        static void down(void* data, zwp_tablet_tool_v2*, uint32_t) {
+            static_cast<tool_state*>(data)->state |= tablet_down;
+        }
+        static void up(void* data, zwp_tablet_tool_v2*) {
+            static_cast<tool_state*>(data)->state &= ~tablet_down;
+        }
+        static void motion(void* data, zwp_tablet_tool_v2*, wl_fixed_t x, wl_fixed_t y) {
+            auto t = static_cast<tool_state*>(data);
+            t->x = static_cast<float>(wl_fixed_to_double(x));
+            t->y = static_cast<float>(wl_fixed_to_double(y));
+        }
+        static void pressure(void* data, zwp_tablet_tool_v2*, uint32_t pressure) {
+            static_cast<tool_state*>(data)->pressure = static_cast<float>(pressure) / 65535.0f;
+        }
+        static void distance(void*, zwp_tablet_tool_v2*, uint32_t) { }
+        static void tilt(void* data, zwp_tablet_tool_v2*, wl_fixed_t tilt_x, wl_fixed_t tilt_y) {
+            auto t = static_cast<tool_state*>(data);
+            t->tilt_x = static_cast<float>(wl_fixed_to_double(tilt_x));
+            t->tilt_y = static_cast<float>(wl_fixed_to_double(tilt_y));
+        }
+        static void rotation(void*, zwp_tablet_tool_v2*, wl_fixed_t) { }
+        static void slider(void*, zwp_tablet_tool_v2*, int32_t) { }
+        static void wheel(void*, zwp_tablet_tool_v2*, wl_fixed_t, int32_t) { }
+        static void button(void*, zwp_tablet_tool_v2*, uint32_t, uint32_t, uint32_t) { }
+        static void frame(void* data, zwp_tablet_tool_v2*, uint32_t time) {
+            auto t = static_cast<tool_state*>(data);
+            CRISS_CROSS_TRACE_INSTANT("tablet.sample", time);
+            t->input->push(*t, time);
+        }
+
+        constexpr static zwp_tablet_seat_v2_listener seat_listener = {
+            .tablet_added = tablet_added,
+            .tool_added = tool_added,
+            .pad_added = pad_added,
+        };
+        constexpr static zwp_tablet_tool_v2_listener tool_listener = {
+            .type = type,
+            .hardware_serial = hardware_serial,
+            .hardware_id_wacom = hardware_id_wacom,
+            .capability = capability,
+            .done = done,
+            .removed = removed,
+            .proximity_in = proximity_in,
+            .proximity_out = proximity_out,
+            .down = down,
+            .up = up,
+            .motion = motion,
+            .pressure = pressure,
+            .distance = distance,
+            .tilt = tilt,
+            .rotation = rotation,
+            .slider = slider,
+            .wheel = wheel,
+            .button = button,
+            .frame = frame,
+        };
+
+    private:
+        zwp_tablet_seat_v2* seat;
+        std::list<tool_state> tools;  // stable addresses, used as listener data
+        uint16_t next_tool = 0;
+        batch_handler handler;
+        ring_type ring;
+        std::atomic<uint32_t> signal = 0;
+        std::atomic<size_t> processed_count = 0;
+        std::jthread worker;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_TABLET_HPP
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include "trace.hpp"
+
+namespace
+{
+    // Cost of one event on the calling thread; the rings are drained
+    // outside the timed region so they never fill, as rarely as their
+    // capacity allows since pausing the timer costs microseconds.
+    constexpr uint64_t drain_mask = decltype (criss_cross::trace::thread_buffer::ring)::capacity() - 1;
+    void trace_instant(benchmark::State& state) {
+        uint64_t i = 0;
+        for (auto _ : state) {
+            criss_cross::trace::instant("bench.instant", i++);
+            if ((i & drain_mask) == 0) {
+                state.PauseTiming();
+                criss_cross::trace::clear();
+                state.ResumeTiming();
+            }
+        }
+        criss_cross::trace::clear();
+    }
+
+    void trace_scope(benchmark::State& state) {
+        uint64_t i = 0;
+        for (auto _ : state) {
+            criss_cross::trace::scope s{"bench.scope", i++};
+            if ((i & drain_mask) == 0) {
+                state.PauseTiming();
+                criss_cross::trace::clear();
+                state.ResumeTiming();
+            }
+        }
+        criss_cross::trace::clear();
+    }
+
+    // the floor under both: one timestamp
+    void trace_ticks(benchmark::State& state) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(criss_cross::trace::ticks());
+        }
+    }
+
+    void latency_histogram_record(benchmark::State& state) {
+        criss_cross::latency_histogram h;
+        int64_t ns = 1;
+        for (auto _ : state) {
+            h.record(std::chrono::nanoseconds{ns});
+            ns = ns * 7 % 100'000'007;
+        }
+        benchmark::DoNotOptimize(h.percentile(0.99));
+    }
+} // namespace
+
+BENCHMARK(trace_instant);
+BENCHMARK(trace_scope);
+BENCHMARK(trace_ticks);
+BENCHMARK(latency_histogram_record);
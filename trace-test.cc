@@ -0,0 +1,115 @@
+
+#include <gtest/gtest.h>
+
+#include "trace.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class trace_test : public testing::Test {
+protected:
+    void SetUp() override { criss_cross::trace::clear(); }
+    void TearDown() override {}
+};
+
+namespace
+{
+    size_t count(std::string const& text, std::string const& what) {
+        size_t n = 0;
+        for (auto i = text.find(what); i != std::string::npos; i = text.find(what, i + 1)) ++n;
+        return n;
+    }
+} // namespace
+
+TEST_F(trace_test, chrome_json) {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([] {
+            criss_cross::trace::thread_name("worker");
+            for (uint64_t i = 0; i < 100; ++i) {
+                criss_cross::trace::scope s{"work", i};
+                criss_cross::trace::instant("tick", i);
+            }
+        });
+    }
+    threads.clear();
+    criss_cross::trace::instant("main");
+
+    std::ostringstream out;
+    criss_cross::trace::write_json(out);
+    auto json = out.str();
+    ASSERT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    ASSERT_EQ(count(json, "\"name\":\"work\""), 300u);
+    ASSERT_EQ(count(json, "\"name\":\"tick\""), 300u);
+    ASSERT_EQ(count(json, "\"name\":\"main\""), 1u);
+    ASSERT_EQ(count(json, "\"ph\":\"X\""), 300u);
+    ASSERT_EQ(count(json, "\"args\":{\"name\":\"worker\"}"), 3u);
+    ASSERT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    ASSERT_EQ(criss_cross::trace::dropped(), 0u);
+
+    criss_cross::trace::clear();
+    std::ostringstream empty;
+    criss_cross::trace::write_json(empty);
+    ASSERT_EQ(count(empty.str(), "\"ph\":\"X\""), 0u);
+}
+
+TEST_F(trace_test, tick_time) {
+    // event times are counter ticks until collected; they come out as
+    // steady-clock ns
+    auto before = criss_cross::trace::now();
+    {
+        criss_cross::trace::scope s{"sleep"};
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    auto after = criss_cross::trace::now();
+    criss_cross::trace::collect();
+    auto& r = criss_cross::trace::global();
+    std::lock_guard lock{r.mutex};
+    ASSERT_EQ(r.collected.size(), 1u);
+    auto const& e = r.collected.front().second;
+    ASSERT_GE(e.duration, 19'000'000);
+    ASSERT_LE(e.duration, after - before + 1'000'000);
+    ASSERT_GE(e.start, before - 1'000'000);
+    ASSERT_LE(e.start + e.duration, after + 1'000'000);
+}
+
+TEST_F(trace_test, macros) {
+    {
+        CRISS_CROSS_TRACE_SCOPE("macro.scope", 7);
+        CRISS_CROSS_TRACE_INSTANT("macro.instant");
+    }
+    std::ostringstream out;
+    criss_cross::trace::write_json(out);
+#if defined(CRISS_CROSS_TRACE)
+    ASSERT_EQ(count(out.str(), "macro."), 2u);
+#else
+    ASSERT_EQ(count(out.str(), "macro."), 0u);
+#endif
+}
+
+TEST_F(trace_test, histogram) {
+    using namespace std::chrono_literals;
+    criss_cross::latency_histogram h;
+    ASSERT_EQ(h.percentile(0.5), 0ns);
+    for (int i = 1; i <= 1000; ++i) h.record(std::chrono::microseconds{i});
+    ASSERT_EQ(h.size(), 1000u);
+    auto near = [](auto actual, auto expected) {
+        auto a = static_cast<double>(actual.count());
+        auto e = static_cast<double>(std::chrono::nanoseconds{expected}.count());
+        return a >= e && a <= e * (1 + 1.0 / 16);
+    };
+    ASSERT_TRUE(near(h.percentile(0.5), 500us)) << h.percentile(0.5).count();
+    ASSERT_TRUE(near(h.percentile(0.99), 990us)) << h.percentile(0.99).count();
+    ASSERT_TRUE(near(h.percentile(1.0), 1000us)) << h.percentile(1.0).count();
+    h.record(-5ns);
+    ASSERT_EQ(h.percentile(0), 0ns);
+    for (uint64_t v : {0ull, 15ull, 16ull, 31ull, 32ull, 1000ull, ~0ull >> 1}) {
+        criss_cross::latency_histogram one;
+        one.record(std::chrono::nanoseconds{static_cast<int64_t>(v)});
+        auto p = static_cast<uint64_t>(one.percentile(0.5).count());
+        ASSERT_GE(p, v);
+        ASSERT_LE(p, v + v / 16);
+    }
+}
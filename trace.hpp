@@ -0,0 +1,287 @@
+#ifndef INCLUDE_TRACE_HPP
+#define INCLUDE_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <aux/spsc-ring.hpp>
+
+// Trace points compile to nothing unless CRISS_CROSS_TRACE is defined (the
+// CMake option of the same name).  The machinery below is always there, so
+// a translation unit may call it directly whatever the setting.
+#if defined(CRISS_CROSS_TRACE)
+#define CRISS_CROSS_TRACE_CONCAT_(a, b) a##b
+#define CRISS_CROSS_TRACE_CONCAT(a, b) CRISS_CROSS_TRACE_CONCAT_(a, b)
+#define CRISS_CROSS_TRACE_SCOPE(name, ...) \
+    criss_cross::trace::scope CRISS_CROSS_TRACE_CONCAT(trace_scope_, __LINE__){name __VA_OPT__(,) __VA_ARGS__}
+#define CRISS_CROSS_TRACE_INSTANT(name, ...) criss_cross::trace::instant(name __VA_OPT__(,) __VA_ARGS__)
+#define CRISS_CROSS_TRACE_THREAD(name) criss_cross::trace::thread_name(name)
+#else
+#define CRISS_CROSS_TRACE_SCOPE(...) static_cast<void>(0)
+#define CRISS_CROSS_TRACE_INSTANT(...) static_cast<void>(0)
+#define CRISS_CROSS_TRACE_THREAD(...) static_cast<void>(0)
+#endif
+
+namespace criss_cross
+{
+    namespace trace
+    {
+        using clock = std::chrono::steady_clock;
+
+        // One timestamped event; names are string literals.  A scope is one
+        // event carrying its duration, an instant has none.  Rings hold
+        // times in ticks(); collect() turns them into ns.
+        struct event {
+            char const* name;
+            int64_t start;       // ns, steady clock
+            int64_t duration;    // ns, < 0 for instants
+            uint64_t value;      // free argument (sample time, count, ...)
+        };
+
+        inline int64_t now() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+        }
+
+        // Event timestamps: the CPU's constant-rate counter (TSC, the
+        // AArch64 virtual counter), a few ns to read against some 20 for
+        // clock::now(), or now() itself elsewhere.
+        inline int64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            return static_cast<int64_t>(__rdtsc());
+#elif defined(__aarch64__)
+            uint64_t ret;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ret));
+            return static_cast<int64_t>(ret);
+#else
+            return now();
+#endif
+        }
+
+        // ticks() against the steady clock, measured from the first use of
+        // tracing; every collect() refines the rate over the longer span.
+        class tick_clock {
+        public:
+            tick_clock() noexcept
+                : tick0{ticks()}
+                , ns0{now()}
+            {
+                // a first rate over 1 ms, for events collected right away
+                while (now() - ns0 < 1'000'000) continue;
+                calibrate();
+            }
+
+        public:
+            void calibrate() noexcept {
+                auto t = ticks();
+                auto n = now();
+                if (t != tick0) rate = static_cast<double>(n - ns0) / static_cast<double>(t - tick0);
+            }
+            int64_t ns(int64_t t) const noexcept { return ns0 + duration(t - tick0); }
+            int64_t duration(int64_t t) const noexcept { return static_cast<int64_t>(static_cast<double>(t) * rate); }
+
+        private:
+            int64_t tick0;
+            int64_t ns0;
+            double rate = 1;   // ns per tick
+        };
+
+        // Per-thread lock-free ring; the owning thread is its only producer
+        // and collect() its only consumer.  Rings outlive their threads, so
+        // events of a finished thread can still be collected.
+        struct thread_buffer {
+            aux::spsc_ring<event, 1 << 14> ring;
+            uint32_t tid;
+            std::string name;
+        };
+
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<thread_buffer>> threads;
+            std::vector<std::pair<uint32_t, event>> collected;   // guarded by mutex
+            tick_clock time;                                       // guarded by mutex
+        };
+        inline registry& global() {
+            static registry ret;
+            return ret;
+        }
+
+        // The registry owns the buffer; the constant-initialized pointer
+        // spares every event a thread_local guard check.
+        [[gnu::noinline]] inline thread_buffer* attach() {
+            auto& r = global();
+            std::lock_guard lock{r.mutex};
+            auto b = std::make_shared<thread_buffer>();
+            b->tid = static_cast<uint32_t>(r.threads.size() + 1);
+            r.threads.push_back(b);
+            return b.get();
+        }
+        inline thread_buffer& local() {
+            thread_local constinit thread_buffer* buffer = nullptr;
+            if (!buffer) [[unlikely]] buffer = attach();
+            return *buffer;
+        }
+
+        inline void record(event const& e) noexcept {
+            local().ring.try_push(e);   // full: dropped, see dropped()
+        }
+        inline void instant(char const* name, uint64_t value = 0) noexcept {
+            record({name, ticks(), -1, value});
+        }
+        inline void thread_name(char const* name) {
+            auto& b = local();
+            std::lock_guard lock{global().mutex};
+            b.name = name;
+        }
+
+        class scope {
+        public:
+            explicit scope(char const* name, uint64_t value = 0) noexcept
+                : name{name}
+                , value{value}
+                , start{ticks()}
+            {
+            }
+            scope(scope const&) = delete;
+            scope& operator=(scope const&) = delete;
+            ~scope() { record({name, start, ticks() - start, value}); }
+
+        private:
+            char const* name;
+            uint64_t value;
+            int64_t start;
+        };
+
+        // Moves the events of every ring into the registry.  Call it now and
+        // then (once a frame) so the rings do not overflow.
+        inline void collect() {
+            auto& r = global();
+            std::lock_guard lock{r.mutex};
+            r.time.calibrate();
+            std::array<event, 256> batch;
+            for (auto const& t : r.threads) {
+                while (auto n = t->ring.drain(batch)) {
+                    for (size_t i = 0; i < n; ++i) {
+                        auto e = batch[i];
+                        e.start = r.time.ns(e.start);
+                        if (e.duration >= 0) e.duration = r.time.duration(e.duration);
+                        r.collected.emplace_back(t->tid, e);
+                    }
+                }
+            }
+        }
+
+        inline size_t dropped() {
+            auto& r = global();
+            std::lock_guard lock{r.mutex};
+            size_t ret = 0;
+            for (auto const& t : r.threads) ret += t->ring.dropped();
+            return ret;
+        }
+
+        // Forgets everything collected so far.
+        inline void clear() {
+            collect();
+            auto& r = global();
+            std::lock_guard lock{r.mutex};
+            r.collected.clear();
+        }
+
+        // Collects and writes all events as Chrome trace-event JSON
+        // (chrome://tracing, Perfetto): scopes as complete ("X") events,
+        // instants as thread-scoped "i" events, times in microseconds.
+        inline void write_json(std::ostream& out) {
+            collect();
+            auto& r = global();
+            std::lock_guard lock{r.mutex};
+            auto events = r.collected;
+            std::stable_sort(events.begin(), events.end(), [](auto const& a, auto const& b) {
+                return a.second.start < b.second.start;
+            });
+            auto origin = events.empty() ? 0 : events.front().second.start;
+            auto us = [](int64_t ns) { return static_cast<double>(ns) / 1000; };
+            out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            char const* sep = "\n";
+            for (auto const& t : r.threads) {
+                if (t->name.empty()) continue;
+                out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t->tid
+                    << ",\"args\":{\"name\":\"" << t->name << "\"}}";
+                sep = ",\n";
+            }
+            for (auto const& [tid, e] : events) {
+                out << sep << "{\"name\":\"" << e.name << "\",\"pid\":1,\"tid\":" << tid
+                    << ",\"ts\":" << us(e.start - origin);
+                if (e.duration < 0) {
+                    out << ",\"ph\":\"i\",\"s\":\"t\"";
+                }
+                else {
+                    out << ",\"ph\":\"X\",\"dur\":" << us(e.duration);
+                }
+                out << ",\"args\":{\"value\":" << e.value << "}}";
+                sep = ",\n";
+            }
+            out << "\n]}\n";
+        }
+    } // ::trace
+
+    // Log-linear histogram of durations, 16 sub-buckets per power of two of
+    // nanoseconds, so a percentile is off by at most 1/16.  Not thread safe.
+    class latency_histogram {
+    public:
+        using duration = std::chrono::nanoseconds;
+
+    public:
+        void record(duration d) noexcept {
+            auto ns = static_cast<uint64_t>(std::max<int64_t>(d.count(), 0));
+            ++counts[bucket(ns)];
+            ++total;
+        }
+
+        size_t size() const noexcept { return total; }
+
+        // Upper bound of the bucket holding the p-th fraction (0..1) of the
+        // samples; zero when empty.
+        duration percentile(double p) const noexcept {
+            if (total == 0) return {};
+            auto rank = static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(total - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= rank) return duration{static_cast<int64_t>(upper(i))};
+            }
+            return duration{static_cast<int64_t>(upper(counts.size() - 1))};
+        }
+
+    private:
+        static constexpr size_t sub = 16;
+
+        static size_t bucket(uint64_t ns) noexcept {
+            if (ns < sub) return ns;
+            auto shift = static_cast<size_t>(std::bit_width(ns)) - 5;   // keep the top 5 bits
+            return (shift + 1) * sub + ((ns >> shift) - sub);
+        }
+        static uint64_t upper(size_t i) noexcept {
+            if (i < sub) return i;
+            auto shift = i / sub - 1;
+            return ((sub + i % sub + 1) << shift) - 1;
+        }
+
+    private:
+        std::array<uint64_t, 64 * sub> counts{};
+        uint64_t total = 0;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_TRACE_HPP
@@ -0,0 +1,92 @@
+#ifndef INCLUDE_WINDOW_HPP
+#define INCLUDE_WINDOW_HPP
+
+#include <cstdint>
+
+#include <wayland-client.h>
+#include <xdg-shell-client.h>
+
+namespace criss_cross
+{
+    // xdg_toplevel wrapper: owns the wl_surface, acks configures and keeps
+    // the size the compositor asked for.
+    class window {
+    public:
+        window(wl_compositor* compositor, xdg_wm_base* wm_base, char const* title,
+               int width = 800, int height = 600)
+            : surface{wl_compositor_create_surface(compositor)}
+            , xsurface{xdg_wm_base_get_xdg_surface(wm_base, surface)}
+            , toplevel{xdg_surface_get_toplevel(xsurface)}
+            , w{width}
+            , h{height}
+        {
+            xdg_wm_base_add_listener(wm_base, &wm_base_listener, this);
+            xdg_surface_add_listener(xsurface, &xsurface_listener, this);
+            xdg_toplevel_add_listener(toplevel, &toplevel_listener, this);
+            xdg_toplevel_set_title(toplevel, title);
+            xdg_toplevel_set_app_id(toplevel, "criss-cross");
+            wl_surface_commit(surface);
+        }
+        window(window const&) = delete;
+        window& operator=(window const&) = delete;
+
+        ~window() {
+            xdg_toplevel_destroy(toplevel);
+            xdg_surface_destroy(xsurface);
+            wl_surface_destroy(surface);
+        }
+
+    public:
+        wl_surface* get_surface() const noexcept { return surface; }
+        int width() const noexcept { return w; }
+        int height() const noexcept { return h; }
+        bool configured() const noexcept { return acked; }
+        bool closed() const noexcept { return close_requested; }
+
+    private:
+        static void on_ping(void*, xdg_wm_base* base, uint32_t serial) {
+            xdg_wm_base_pong(base, serial);
+        }
+        static void on_surface_configure(void* data, xdg_surface* xsurface, uint32_t serial) {
+            xdg_surface_ack_configure(xsurface, serial);
+            static_cast<window*>(data)->acked = true;
+        }
+        static void on_toplevel_configure(void* data, xdg_toplevel*, int32_t width, int32_t height, wl_array*) {
+            auto self = static_cast<window*>(data);
+            if (width > 0 && height > 0) {
+                self->w = width;
+                self->h = height;
+            }
+        }
+        static void on_close(void* data, xdg_toplevel*) {
+            static_cast<window*>(data)->close_requested = true;
+        }
+
+        constexpr static xdg_wm_base_listener wm_base_listener = {
+            .ping = on_ping,
+        };
+        constexpr static xdg_surface_listener xsurface_listener = {
+            .configure = on_surface_configure,
+        };
+        // xdg_wm_base is bound at version 1, so the later toplevel events
+        // (configure_bounds, wm_capabilities) are never sent; leave them null
+        // whatever protocol version the header was generated from.
+        constexpr static xdg_toplevel_listener toplevel_listener = [] {
+            xdg_toplevel_listener ret{};
+            ret.configure = on_toplevel_configure;
+            ret.close = on_close;
+            return ret;
+        }();
+
+    private:
+        wl_surface* surface;
+        xdg_surface* xsurface;
+        xdg_toplevel* toplevel;
+        int w;
+        int h;
+        bool acked = false;
+        bool close_requested = false;
+    };
+} // ::criss_cross
+
+#endif // INCLUDE_WINDOW_HPP